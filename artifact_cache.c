@@ -0,0 +1,400 @@
+/*
+ * Copyright (C) 2026  sunxi-tools developers
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**********************************************************************
+ * Content-addressed cache of data derived from sunxi-fel input
+ *
+ * Layout below the cache directory:
+ *   objects/<sha256>/meta   "key value" lines, e.g. payload sizes and CRCs
+ *   objects/<sha256>/<name> payloads, e.g. decompressed FIT images
+ *
+ * Files get written to a temporary name and renamed into place, so
+ * concurrent runs never see partial data.
+ **********************************************************************/
+#include "artifact_cache.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "crc32.h"
+#include "digest.h"
+
+#define CACHE_HASH_HEX	(SHA256_DIGEST_SIZE * 2)
+#define CACHE_MAX_META	64
+/* room for file names below an object directory */
+#define CACHE_NAME_MAX	256
+
+struct artifact {
+	char dir[PATH_MAX - CACHE_NAME_MAX];	/* objects/<sha256> */
+	size_t count;
+	struct {
+		char *key, *value;
+	} meta[CACHE_MAX_META];
+};
+
+struct artifact_payload {
+	artifact_t *art;
+	FILE *file;
+	char path[PATH_MAX], tmp[PATH_MAX], key[128];
+	size_t size, want_size;		/* bytes so far, and the recorded size */
+	uint32_t crc, want_crc;
+	bool failed;
+};
+
+static bool cache_enabled;
+
+void artifact_cache_enable(void)
+{
+	cache_enabled = true;
+}
+
+/* $XDG_CACHE_HOME/sunxi-tools or ~/.cache/sunxi-tools, NULL if neither */
+static const char *cache_root(void)
+{
+	static char root[PATH_MAX];
+	const char *base = getenv("XDG_CACHE_HOME");
+	int len;
+
+	if (root[0])
+		return root;
+	if (base && base[0] == '/')
+		len = snprintf(root, sizeof(root), "%s/sunxi-tools", base);
+	else if ((base = getenv("HOME")) && base[0])
+		len = snprintf(root, sizeof(root), "%s/.cache/sunxi-tools",
+			       base);
+	else
+		return NULL;
+	if (len < 0 || (size_t)len >= sizeof(root)) {
+		root[0] = '\0';
+		return NULL;
+	}
+	return root;
+}
+
+/* create 'path' and all its missing parents */
+static bool make_dirs(const char *path)
+{
+	char buf[PATH_MAX], *p;
+
+	if (strlen(path) >= sizeof(buf))
+		return false;
+	strcpy(buf, path);
+	for (p = buf + 1; *p; p++) {
+		if (*p != '/')
+			continue;
+		*p = '\0';
+		if (mkdir(buf, 0755) != 0 && errno != EEXIST)
+			return false;
+		*p = '/';
+	}
+	return mkdir(buf, 0755) == 0 || errno == EEXIST;
+}
+
+static void to_hex(const uint8_t *data, size_t len, char *out)
+{
+	static const char digits[] = "0123456789abcdef";
+
+	while (len--) {
+		*out++ = digits[*data >> 4];
+		*out++ = digits[*data++ & 0xF];
+	}
+	*out = '\0';
+}
+
+static void *read_file(const char *path, size_t *size)
+{
+	FILE *f = fopen(path, "rb");
+	uint8_t *buf = NULL;
+	long len;
+
+	if (!f)
+		return NULL;
+	if (fseek(f, 0, SEEK_END) == 0 && (len = ftell(f)) >= 0 &&
+	    fseek(f, 0, SEEK_SET) == 0 && (buf = malloc(len + 1)) != NULL) {
+		if (fread(buf, 1, len, f) == (size_t)len) {
+			buf[len] = '\0';	/* handy for text files */
+			*size = len;
+		} else {
+			free(buf);
+			buf = NULL;
+		}
+	}
+	fclose(f);
+	return buf;
+}
+
+/* write a file atomically, ignoring errors (the cache is best effort) */
+static void write_file(const char *path, const void *data, size_t size)
+{
+	char tmp[PATH_MAX];
+	FILE *f;
+	int len;
+
+	len = snprintf(tmp, sizeof(tmp), "%s.tmp%ld", path, (long)getpid());
+	if (len < 0 || (size_t)len >= sizeof(tmp) || !(f = fopen(tmp, "wb")))
+		return;
+	if (fwrite(data, 1, size, f) != size || fclose(f) != 0 ||
+	    rename(tmp, path) != 0)
+		unlink(tmp);
+}
+
+static void read_meta(artifact_t *art)
+{
+	char path[PATH_MAX], *text, *line, *next, *value;
+	size_t size;
+
+	snprintf(path, sizeof(path), "%s/meta", art->dir);
+	text = read_file(path, &size);
+	if (!text)
+		return;
+	for (line = text; *line && art->count < CACHE_MAX_META; line = next) {
+		next = strchr(line, '\n');
+		if (!next)
+			break;		/* incomplete line */
+		*next++ = '\0';
+		value = strchr(line, ' ');
+		if (!value)
+			continue;
+		*value++ = '\0';
+		art->meta[art->count].key = strdup(line);
+		art->meta[art->count].value = strdup(value);
+		art->count++;
+	}
+	free(text);
+}
+
+static void write_meta(artifact_t *art)
+{
+	char path[PATH_MAX], *text;
+	size_t i, size = 1, len = 0;
+
+	for (i = 0; i < art->count; i++)
+		size += strlen(art->meta[i].key) +
+			strlen(art->meta[i].value) + 2;
+	text = malloc(size);
+	if (!text)
+		return;
+	for (i = 0; i < art->count; i++)
+		len += sprintf(text + len, "%s %s\n",
+			       art->meta[i].key, art->meta[i].value);
+	snprintf(path, sizeof(path), "%s/meta", art->dir);
+	write_file(path, text, len);
+	free(text);
+}
+
+/*
+ * The data always gets hashed: file metadata (size, time stamps) could be
+ * the same for different contents.
+ */
+artifact_t *artifact_open(const void *data, size_t size)
+{
+	const char *root = cache_root();
+	char content[CACHE_HASH_HEX + 1];
+	uint8_t digest[SHA256_DIGEST_SIZE];
+	sha256_ctx_t ctx;
+	artifact_t *art;
+	int n;
+
+	if (!cache_enabled || !root)
+		return NULL;
+
+	sha256_init(&ctx);
+	sha256_update(&ctx, data, size);
+	sha256_final(&ctx, digest);
+	to_hex(digest, sizeof(digest), content);
+
+	art = calloc(1, sizeof(*art));
+	if (!art)
+		return NULL;
+	n = snprintf(art->dir, sizeof(art->dir), "%s/objects/%s",
+		     root, content);
+	if (n < 0 || (size_t)n >= sizeof(art->dir) || !make_dirs(art->dir)) {
+		free(art);
+		return NULL;
+	}
+	read_meta(art);
+	return art;
+}
+
+void artifact_close(artifact_t *art)
+{
+	size_t i;
+
+	if (!art)
+		return;
+	for (i = 0; i < art->count; i++) {
+		free(art->meta[i].key);
+		free(art->meta[i].value);
+	}
+	free(art);
+}
+
+const char *artifact_get(artifact_t *art, const char *key)
+{
+	size_t i;
+
+	if (!art)
+		return NULL;
+	for (i = 0; i < art->count; i++)
+		if (strcmp(art->meta[i].key, key) == 0)
+			return art->meta[i].value;
+	return NULL;
+}
+
+void artifact_set(artifact_t *art, const char *key, const char *value)
+{
+	size_t i;
+
+	/* keys and values are single words / lines */
+	if (!art || strpbrk(key, " \n") || strchr(value, '\n'))
+		return;
+	for (i = 0; i < art->count; i++)
+		if (strcmp(art->meta[i].key, key) == 0)
+			break;
+	if (i == art->count) {
+		if (i == CACHE_MAX_META)
+			return;
+		art->meta[i].key = strdup(key);
+		art->count++;
+	} else if (strcmp(art->meta[i].value, value) == 0) {
+		return;
+	} else {
+		free(art->meta[i].value);
+	}
+	art->meta[i].value = strdup(value);
+	write_meta(art);
+}
+
+/* file name for a payload, and the meta key with its size and CRC */
+static bool payload_names(artifact_t *art, const char *name,
+			  char *path, char *key)
+{
+	char *p;
+	int n;
+
+	n = snprintf(key, 128, "payload.%s", name);
+	if (n < 0 || n >= 128)
+		return false;
+	for (p = key + 8; *p; p++)
+		if (!strchr("abcdefghijklmnopqrstuvwxyz"
+			    "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-_.@", *p))
+			*p = '_';
+	n = snprintf(path, PATH_MAX, "%s/%s", art->dir, key);
+	return n > 0 && n < PATH_MAX;
+}
+
+artifact_payload_t *artifact_load_begin(artifact_t *art, const char *name,
+					size_t *size)
+{
+	artifact_payload_t *payload;
+	unsigned long long want_size;
+	unsigned int want_crc;
+	const char *value;
+
+	payload = art ? calloc(1, sizeof(*payload)) : NULL;
+	if (!payload)
+		return NULL;
+	if (!payload_names(art, name, payload->path, payload->key) ||
+	    !(value = artifact_get(art, payload->key)) ||
+	    sscanf(value, "%llu %x", &want_size, &want_crc) != 2 ||
+	    !(payload->file = fopen(payload->path, "rb"))) {
+		free(payload);
+		return NULL;
+	}
+	payload->want_size = want_size;
+	payload->want_crc = want_crc;
+	*size = want_size;
+	return payload;
+}
+
+size_t artifact_load_read(artifact_payload_t *payload, void *buf, size_t len)
+{
+	size_t n = fread(buf, 1, len, payload->file);
+
+	payload->crc = crc32_update(payload->crc, buf, n);
+	payload->size += n;
+	return n;
+}
+
+bool artifact_load_end(artifact_payload_t *payload)
+{
+	bool ok = payload->size == payload->want_size &&
+		  payload->crc == payload->want_crc &&
+		  fgetc(payload->file) == EOF;
+
+	fclose(payload->file);
+	free(payload);
+	return ok;
+}
+
+artifact_payload_t *artifact_store_begin(artifact_t *art, const char *name)
+{
+	artifact_payload_t *payload;
+	int len;
+
+	payload = art ? calloc(1, sizeof(*payload)) : NULL;
+	if (!payload)
+		return NULL;
+	payload->art = art;
+	if (payload_names(art, name, payload->path, payload->key)) {
+		len = snprintf(payload->tmp, sizeof(payload->tmp), "%s.tmp%ld",
+			       payload->path, (long)getpid());
+		if (len > 0 && (size_t)len < sizeof(payload->tmp))
+			payload->file = fopen(payload->tmp, "wb");
+	}
+	if (!payload->file) {
+		free(payload);
+		return NULL;
+	}
+	return payload;
+}
+
+void artifact_store_write(artifact_payload_t *payload,
+			  const void *data, size_t size)
+{
+	if (!payload || payload->failed)
+		return;
+	if (fwrite(data, 1, size, payload->file) != size)
+		payload->failed = true;
+	payload->crc = crc32_update(payload->crc, data, size);
+	payload->size += size;
+}
+
+/* written to a temporary file first, renamed into place when complete */
+void artifact_store_end(artifact_payload_t *payload, bool keep)
+{
+	char value[64];
+
+	if (!payload)
+		return;
+	if (fclose(payload->file) != 0)
+		payload->failed = true;
+	if (keep && !payload->failed &&
+	    rename(payload->tmp, payload->path) == 0) {
+		snprintf(value, sizeof(value), "%zu %08x", payload->size,
+			 payload->crc);
+		artifact_set(payload->art, payload->key, value);
+	} else {
+		unlink(payload->tmp);
+	}
+	free(payload);
+}
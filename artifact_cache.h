@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2026  sunxi-tools developers
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _SUNXI_TOOLS_ARTIFACT_CACHE_H
+#define _SUNXI_TOOLS_ARTIFACT_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * A local cache of data derived from what sunxi-fel uploads, i.e. of the
+ * decompressed FIT images, so repeated runs can skip the decompression.
+ * Cheap checks (checksums, CRCs) don't go through here, as the lookup
+ * would cost more than they do.
+ *
+ * Entries are addressed by the SHA-256 of the source data (e.g. the
+ * compressed image), which gets computed on every run. The cache lives in
+ * $XDG_CACHE_HOME/sunxi-tools (or ~/.cache/sunxi-tools), and is only used
+ * when enabled. It is best effort: any failure to access it just results in
+ * a cache miss. Nothing gets evicted, the user removes the directory.
+ *
+ * All functions accept a NULL artifact (no cache), and then report misses.
+ */
+typedef struct artifact artifact_t;
+typedef struct artifact_payload artifact_payload_t;
+
+/* globally turn the cache on, for --cache */
+void artifact_cache_enable(void);
+
+/* open the cache entry for the source data 'data' */
+artifact_t *artifact_open(const void *data, size_t size);
+void artifact_close(artifact_t *art);
+
+/* facts about the source data, as key/value strings */
+const char *artifact_get(artifact_t *art, const char *key);
+void artifact_set(artifact_t *art, const char *key, const char *value);
+
+/*
+ * Payloads derived from the source data, e.g. decompressed FIT images. They get
+ * streamed in pieces, so they never have to be held in memory as a whole.
+ *
+ * artifact_load_begin() returns NULL if there's no such payload, otherwise
+ * the recorded size is stored in 'size'. artifact_load_end() tells whether
+ * the data read matched that size and the recorded CRC, i.e. the caller
+ * needs to be able to discard what it read.
+ *
+ * A stored payload only shows up once artifact_store_end() is called with
+ * 'keep' set. Writes after a failure are ignored.
+ */
+artifact_payload_t *artifact_load_begin(artifact_t *art, const char *name,
+					size_t *size);
+size_t artifact_load_read(artifact_payload_t *payload, void *buf, size_t len);
+bool artifact_load_end(artifact_payload_t *payload);
+
+artifact_payload_t *artifact_store_begin(artifact_t *art, const char *name);
+void artifact_store_write(artifact_payload_t *payload,
+			  const void *data, size_t size);
+void artifact_store_end(artifact_payload_t *payload, bool keep);
+
+#endif /* _SUNXI_TOOLS_ARTIFACT_CACHE_H */
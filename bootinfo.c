@@ -26,6 +26,7 @@
 #include <stdarg.h>
 
 #include "common.h"
+#include "egon_image.h"
 #include "types.h"
 
 /* boot_file_head copied from mksunxiboot */
@@ -166,6 +167,9 @@ void fail(char *msg) {
 	exit(1);
 }
 
+/* result of the checksum verification, see check_egon_checksum() */
+static char checksum_info[64];
+
 void pprintf(void *addr, const char *fmt, ...)
 {
 	va_list ap;
@@ -187,6 +191,7 @@ void print_brom_file_head(brom_file_head_t *hdr)
 void print_boot_file_head(boot_file_head_t *hdr)
 {
 	pprintf(&hdr->magic,		"Magic     : %.8s\n", hdr->magic);
+	pprintf(&hdr->check_sum,	"Checksum  : 0x%08x (%s)\n", hdr->check_sum, checksum_info);
 	pprintf(&hdr->length,		"Length    : %u\n", hdr->length);
 	pprintf(&hdr->pub_head_size,	"HSize     : %u\n", hdr->pub_head_size);
 	pprintf(&hdr->pub_head_vsn,	"HEAD ver  : %.4s\n", hdr->pub_head_vsn);
@@ -336,6 +341,29 @@ void print_boot1_file_head(boot1_file_head_t *hdr, loader_type type)
 		printf("Unknown boot0 header version\n");
 }
 
+/* verify the checksum, reading the rest of the image (beyond the header) */
+void check_egon_checksum(FILE *in, size_t len)
+{
+	size_t length = egon_length(&boot_hdr);
+	uint8_t *buf = malloc(length > len ? length : len);
+	egon_status_t status;
+	uint32_t sum;
+
+	if (!buf)
+		fail("malloc");
+	memcpy(buf, &boot_hdr, len);
+	if (length > len)
+		len += fread(buf + len, 1, length - len, in);
+	status = egon_verify(buf, len, &sum);
+	if (status == EGON_BAD_CHECKSUM)
+		snprintf(checksum_info, sizeof(checksum_info), "%s, expected 0x%08x",
+			 egon_status_str(status), sum);
+	else
+		snprintf(checksum_info, sizeof(checksum_info), "%s",
+			 egon_status_str(status));
+	free(buf);
+}
+
 static void usage(const char *cmd)
 {
 	puts("sunxi-bootinfo " VERSION "\n");
@@ -370,6 +398,8 @@ int main(int argc, char * argv[])
 	len = fread(&boot_hdr, 1, sizeof(boot_hdr), in);
 	if (len < (int)sizeof(boot_file_head_t))
 		fail("Failed to read header:");
+	if (egon_magic(&boot_hdr, len))
+		check_egon_checksum(in, len);
 	if (strncmp((char *)boot_hdr.boot.magic, BOOT0_MAGIC, strlen(BOOT0_MAGIC)) == 0) {
 		print_boot0_file_head(&boot_hdr.boot0, type);
 	} else if (strncmp((char *)boot_hdr.boot.magic, BOOT1_MAGIC, strlen(BOOT1_MAGIC)) == 0) {
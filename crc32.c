@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2026  sunxi-tools developers
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**********************************************************************
+ * CRC-32, shared by sunxi-fel (U-Boot images, FIT hashes) and
+ * sunxi-nand-part (MBR)
+ *
+ * The portable code uses "slice-by-16" lookup tables, processing 16 bytes
+ * per iteration. On x86-64 hosts with PCLMULQDQ, larger buffers get folded
+ * with carry-less multiplication instead (Intel's "Fast CRC Computation for
+ * Generic Polynomials Using PCLMULQDQ Instruction" white paper), and on
+ * ARMv8 hosts with the CRC32 extension the dedicated instructions are used.
+ * The choice is made once at startup. Building with -DCRC32_NO_HW leaves
+ * just the portable code (tests/ uses that to cover it on any host).
+ **********************************************************************/
+#include "crc32.h"
+
+#include <stdbool.h>
+
+#if defined(CRC32_NO_HW)
+/* portable code only */
+#elif defined(__x86_64__) && defined(__GNUC__)
+#define CRC32_PCLMUL
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__GNUC__) && \
+	(defined(__ARM_FEATURE_CRC32) || \
+	 (defined(__linux__) && (defined(__clang__) || __GNUC__ >= 10)))
+#define CRC32_ARMV8
+#include <arm_acle.h>
+#ifndef __ARM_FEATURE_CRC32
+#include <sys/auxv.h>
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32	(1 << 7)
+#endif
+#endif
+#endif
+
+#define CRC32_POLY	0xEDB88320
+
+static uint32_t crc32_table[16][256];
+#if defined(CRC32_PCLMUL) || defined(CRC32_ARMV8)
+static bool crc32_have_hw;
+#endif
+
+static uint32_t get_le32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | (uint32_t)p[1] << 8 |
+	       (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+/*
+ * Fill the tables before main() runs, so concurrent callers (e.g. the CRC
+ * threads of sunxi-fel) never race on the initialization.
+ */
+__attribute__((constructor))
+static void crc32_init(void)
+{
+	uint32_t crc;
+	unsigned int i, j;
+
+	for (i = 0; i < 256; i++) {
+		crc = i;
+		for (j = 0; j < 8; j++)
+			crc = (crc >> 1) ^ (crc & 1 ? CRC32_POLY : 0);
+		crc32_table[0][i] = crc;
+	}
+	/* table[k][i]: CRC of byte i followed by k zero bytes */
+	for (i = 0; i < 256; i++)
+		for (j = 1; j < 16; j++) {
+			crc = crc32_table[j - 1][i];
+			crc32_table[j][i] = (crc >> 8) ^ crc32_table[0][crc & 0xFF];
+		}
+
+#if defined(CRC32_PCLMUL)
+	__builtin_cpu_init();
+	crc32_have_hw = __builtin_cpu_supports("pclmul") &&
+			__builtin_cpu_supports("sse4.1");
+#elif defined(CRC32_ARMV8) && defined(__ARM_FEATURE_CRC32)
+	crc32_have_hw = true;
+#elif defined(CRC32_ARMV8)
+	crc32_have_hw = (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#endif
+}
+
+/* 'crc' is the internal (inverted) state here, and for the helpers below */
+static uint32_t crc32_bytes(uint32_t crc, const uint8_t *p, size_t len)
+{
+	while (len--)
+		crc = (crc >> 8) ^ crc32_table[0][(crc ^ *p++) & 0xFF];
+	return crc;
+}
+
+static uint32_t crc32_slice16(uint32_t crc, const uint8_t *p, size_t len)
+{
+	const uint32_t (*t)[256] = crc32_table;
+	uint32_t w0, w1, w2, w3;
+
+	while (len >= 16) {
+		w0 = get_le32(p) ^ crc;
+		w1 = get_le32(p + 4);
+		w2 = get_le32(p + 8);
+		w3 = get_le32(p + 12);
+		crc = t[15][w0 & 0xFF] ^ t[14][(w0 >> 8) & 0xFF] ^
+		      t[13][(w0 >> 16) & 0xFF] ^ t[12][w0 >> 24] ^
+		      t[11][w1 & 0xFF] ^ t[10][(w1 >> 8) & 0xFF] ^
+		      t[9][(w1 >> 16) & 0xFF] ^ t[8][w1 >> 24] ^
+		      t[7][w2 & 0xFF] ^ t[6][(w2 >> 8) & 0xFF] ^
+		      t[5][(w2 >> 16) & 0xFF] ^ t[4][w2 >> 24] ^
+		      t[3][w3 & 0xFF] ^ t[2][(w3 >> 8) & 0xFF] ^
+		      t[1][(w3 >> 16) & 0xFF] ^ t[0][w3 >> 24];
+		p += 16;
+		len -= 16;
+	}
+	return crc32_bytes(crc, p, len);
+}
+
+#ifdef CRC32_PCLMUL
+/*
+ * Fold 64 bytes per iteration (four 128-bit lanes), then reduce to a single
+ * lane and finally to 32 bits with a Barrett reduction. 'len' must be a
+ * multiple of 16, and at least 64. The constants are the bit-reflected
+ * x^n mod P(x) values from the white paper.
+ */
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t crc32_pclmul(uint32_t crc, const uint8_t *p, size_t len)
+{
+	const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+	const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+	const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124);
+	const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+	const __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+	__m128i x1, x2, x3, x4, t1, t2, t3, t4;
+
+	x1 = _mm_loadu_si128((const __m128i *)(p + 0x00));
+	x2 = _mm_loadu_si128((const __m128i *)(p + 0x10));
+	x3 = _mm_loadu_si128((const __m128i *)(p + 0x20));
+	x4 = _mm_loadu_si128((const __m128i *)(p + 0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+	p += 64;
+	len -= 64;
+
+	while (len >= 64) {
+		t1 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+		t2 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+		t3 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+		t4 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, t1),
+			_mm_loadu_si128((const __m128i *)(p + 0x00)));
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, t2),
+			_mm_loadu_si128((const __m128i *)(p + 0x10)));
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, t3),
+			_mm_loadu_si128((const __m128i *)(p + 0x20)));
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, t4),
+			_mm_loadu_si128((const __m128i *)(p + 0x30)));
+		p += 64;
+		len -= 64;
+	}
+
+	/* fold the four lanes into one */
+	t1 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), t1);
+	t1 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), t1);
+	t1 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), t1);
+
+	while (len >= 16) {
+		t1 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, t1),
+			_mm_loadu_si128((const __m128i *)p));
+		p += 16;
+		len -= 16;
+	}
+
+	/* 128 -> 64 bits */
+	x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+	x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k5k0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	/* Barrett reduction to 32 bits */
+	x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), poly, 0x10);
+	x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask), poly, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	return _mm_extract_epi32(x1, 1);
+}
+#endif
+
+#ifdef CRC32_ARMV8
+#if defined(__ARM_FEATURE_CRC32)
+#define CRC32_TARGET
+#elif defined(__clang__)
+#define CRC32_TARGET	__attribute__((target("crc")))
+#else
+#define CRC32_TARGET	__attribute__((target("+crc")))
+#endif
+
+CRC32_TARGET
+static uint32_t crc32_armv8(uint32_t crc, const uint8_t *p, size_t len)
+{
+	uint64_t d;
+
+	while (len && ((uintptr_t)p & 7)) {
+		crc = __crc32b(crc, *p++);
+		len--;
+	}
+	while (len >= 8) {
+		d = (uint64_t)get_le32(p + 4) << 32 | get_le32(p);
+		crc = __crc32d(crc, d);
+		p += 8;
+		len -= 8;
+	}
+	while (len--)
+		crc = __crc32b(crc, *p++);
+	return crc;
+}
+#endif
+
+uint32_t crc32_update(uint32_t crc, const void *buf, size_t len)
+{
+	const uint8_t *p = buf;
+
+	crc = ~crc;
+#if defined(CRC32_PCLMUL)
+	if (crc32_have_hw && len >= 64) {
+		size_t bulk = len & ~(size_t)15;
+
+		crc = crc32_pclmul(crc, p, bulk);
+		p += bulk;
+		len -= bulk;
+	}
+#elif defined(CRC32_ARMV8)
+	if (crc32_have_hw)
+		return ~crc32_armv8(crc, p, len);
+#endif
+	return ~crc32_slice16(crc, p, len);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2026  sunxi-tools developers
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _SUNXI_TOOLS_DIGEST_H
+#define _SUNXI_TOOLS_DIGEST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* SHA-1 and SHA-256 message digests (FIPS 180-4), e.g. for FIT hash nodes */
+#define SHA1_DIGEST_SIZE	20
+#define SHA256_DIGEST_SIZE	32
+
+typedef struct {
+	uint32_t state[5];
+	uint64_t count;		/* total bytes */
+	uint8_t buf[64];
+} sha1_ctx_t;
+
+typedef struct {
+	uint32_t state[8];
+	uint64_t count;		/* total bytes */
+	uint8_t buf[64];
+} sha256_ctx_t;
+
+void sha1_init(sha1_ctx_t *ctx);
+void sha1_update(sha1_ctx_t *ctx, const void *data, size_t len);
+void sha1_final(sha1_ctx_t *ctx, uint8_t digest[SHA1_DIGEST_SIZE]);
+
+void sha256_init(sha256_ctx_t *ctx);
+void sha256_update(sha256_ctx_t *ctx, const void *data, size_t len);
+void sha256_final(sha256_ctx_t *ctx, uint8_t digest[SHA256_DIGEST_SIZE]);
+
+#endif /* _SUNXI_TOOLS_DIGEST_H */
@@ -0,0 +1,300 @@
+/*
+ * Copyright (C) 2026  sunxi-tools developers
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**********************************************************************
+ * sunxi-egon: build, re-stamp and verify eGON boot images (SPL / boot0
+ * and boot1), for single files or whole directories of build artifacts
+ **********************************************************************/
+#include <dirent.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "common.h"
+#include "egon_image.h"
+
+/* default alignment of built images, matching U-Boot's sunxi_egon */
+#define EGON_DEFAULT_ALIGN	8192
+
+typedef enum {
+	CMD_VERIFY,
+	CMD_STAMP,
+} egon_cmd_t;
+
+static bool quiet = false;
+static unsigned int count_ok, count_stamped, count_bad;
+
+/* image buffer, reused (and grown as needed) for all files */
+static uint8_t *image;
+static size_t image_size;
+
+static void usage(const char *cmd)
+{
+	puts("sunxi-egon " VERSION "\n");
+	printf("Usage: %s [-q] verify <file|directory>...\n", cmd);
+	printf("       %s [-q] stamp <file|directory>...\n", cmd);
+	printf("       %s [-q] [-a <align>] [-1] build <input> <output>\n", cmd);
+	puts("\n"
+	"	verify		Check eGON.BT0/eGON.BT1 headers and checksums\n"
+	"	stamp		Recalculate and store the checksums, in place\n"
+	"	build		Put an eGON.BT0 header in front of raw code\n"
+	"\n"
+	"	-q		Only report problems\n"
+	"	-a <align>	Pad built images to a multiple of <align> bytes\n"
+	"			(default 8192)\n"
+	"	-1		Build an eGON.BT1 (boot1) image instead\n"
+	"\n"
+	"Directories are searched recursively, files without an eGON header\n"
+	"are skipped there. The exit status is 1 if any image was invalid.");
+}
+
+static uint8_t *grow_image(size_t size)
+{
+	if (size > image_size) {
+		uint8_t *buf = realloc(image, size);
+		if (!buf)
+			pr_fatal("Failed to allocate %zu bytes\n", size);
+		image = buf;
+		image_size = size;
+	}
+	return image;
+}
+
+/*
+ * Read the header first and then just the 'length' bytes covered by the
+ * checksum, so large non-eGON files in a directory cost next to nothing.
+ */
+static void process_file(const char *path, egon_cmd_t cmd, bool in_dir)
+{
+	FILE *f = fopen(path, cmd == CMD_STAMP ? "r+b" : "rb");
+	size_t size, length;
+	egon_status_t status;
+	struct stat st;
+	uint32_t sum;
+	uint8_t sum_le[4];
+
+	if (!f || fstat(fileno(f), &st) != 0) {
+		pr_error("%s: %s\n", path, strerror(errno));
+		if (f)
+			fclose(f);
+		count_bad++;
+		return;
+	}
+	size = fread(grow_image(EGON_LENGTH_OFFSET + 4), 1,
+		     EGON_LENGTH_OFFSET + 4, f);
+	if (!egon_magic(image, size)) {
+		if (!in_dir) {
+			pr_error("%s: %s\n", path,
+				 egon_status_str(EGON_NO_HEADER));
+			count_bad++;
+		}
+		fclose(f);
+		return;
+	}
+	/* don't trust the header with the buffer size, check the file first */
+	length = egon_length(image);
+	if (length > (size_t)st.st_size) {
+		size = st.st_size;
+		status = EGON_BAD_LENGTH;
+	} else {
+		size += fread(grow_image(length > size ? length : size) + size,
+			      1, length > size ? length - size : 0, f);
+		status = egon_verify(image, size, &sum);
+	}
+	if (status == EGON_BAD_CHECKSUM && cmd == CMD_STAMP) {
+		sum_le[0] = sum;
+		sum_le[1] = sum >> 8;
+		sum_le[2] = sum >> 16;
+		sum_le[3] = sum >> 24;
+		if (fseek(f, EGON_CHECKSUM_OFFSET, SEEK_SET) != 0 ||
+		    fwrite(sum_le, 1, 4, f) != 4) {
+			pr_error("%s: %s\n", path, strerror(errno));
+			count_bad++;
+		} else {
+			if (!quiet)
+				printf("%s: stamped, checksum 0x%08X\n",
+				       path, sum);
+			count_stamped++;
+		}
+	} else if (status == EGON_BAD_CHECKSUM) {
+		pr_error("%s: %s (stored 0x%08X, expected 0x%08X)\n", path,
+			 egon_status_str(status), egon_stored_checksum(image),
+			 sum);
+		count_bad++;
+	} else if (status != EGON_OK) {
+		pr_error("%s: %s (%zu bytes, %zu available)\n", path,
+			 egon_status_str(status), length, size);
+		count_bad++;
+	} else {
+		if (!quiet)
+			printf("%s: OK (%.8s, %zu bytes, checksum 0x%08X)\n",
+			       path, egon_magic(image, size), length, sum);
+		count_ok++;
+	}
+	if (fclose(f) != 0 && cmd == CMD_STAMP) {
+		pr_error("%s: %s\n", path, strerror(errno));
+		count_bad++;
+	}
+}
+
+static int compare_names(const void *a, const void *b)
+{
+	return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+/* files and (recursively) directories, in sorted order */
+static void process_path(const char *path, egon_cmd_t cmd, bool in_dir)
+{
+	struct stat st;
+	struct dirent *entry;
+	char **names = NULL, *name;
+	size_t count = 0, i;
+	DIR *dir;
+
+	if (stat(path, &st) != 0) {
+		pr_error("%s: %s\n", path, strerror(errno));
+		count_bad++;
+		return;
+	}
+	if (!S_ISDIR(st.st_mode)) {
+		if (S_ISREG(st.st_mode) || !in_dir)
+			process_file(path, cmd, in_dir);
+		return;
+	}
+
+	dir = opendir(path);
+	if (!dir) {
+		pr_error("%s: %s\n", path, strerror(errno));
+		count_bad++;
+		return;
+	}
+	while ((entry = readdir(dir)) != NULL) {
+		if (entry->d_name[0] == '.')
+			continue;
+		names = realloc(names, (count + 1) * sizeof(*names));
+		name = malloc(strlen(path) + strlen(entry->d_name) + 2);
+		if (!names || !name)
+			pr_fatal("Failed to allocate memory\n");
+		sprintf(name, "%s/%s", path, entry->d_name);
+		names[count++] = name;
+	}
+	closedir(dir);
+
+	qsort(names, count, sizeof(*names), compare_names);
+	for (i = 0; i < count; i++) {
+		process_path(names[i], cmd, true);
+		free(names[i]);
+	}
+	free(names);
+}
+
+static int build_image(const char *input, const char *output, size_t align,
+		       const char *magic)
+{
+	FILE *in, *out;
+	size_t code_size, size;
+	long file_size;
+	uint32_t sum;
+
+	in = fopen(input, "rb");
+	if (!in || fseek(in, 0, SEEK_END) != 0 || (file_size = ftell(in)) < 0)
+		pr_fatal("%s: %s\n", input, strerror(errno));
+	rewind(in);
+	code_size = file_size;
+	size = (EGON_HEADER_SIZE + code_size + align - 1) / align * align;
+	if (size > UINT32_MAX)
+		pr_fatal("%s: too large for an eGON image\n", input);
+
+	memset(grow_image(size), 0, size);
+	if (fread(image + EGON_HEADER_SIZE, 1, code_size, in) != code_size)
+		pr_fatal("%s: read error\n", input);
+	fclose(in);
+
+	/* ARM branch over the header, to the start of the code */
+	image[0] = EGON_HEADER_SIZE / 4 - 2;
+	image[3] = 0xea;
+	memcpy(image + EGON_MAGIC_OFFSET, magic, 8);
+	image[EGON_LENGTH_OFFSET + 0] = size;
+	image[EGON_LENGTH_OFFSET + 1] = size >> 8;
+	image[EGON_LENGTH_OFFSET + 2] = size >> 16;
+	image[EGON_LENGTH_OFFSET + 3] = size >> 24;
+	egon_stamp(image, size);
+	egon_verify(image, size, &sum);
+
+	out = fopen(output, "wb");
+	if (!out)
+		pr_fatal("%s: %s\n", output, strerror(errno));
+	if (fwrite(image, 1, size, out) != size || fclose(out) != 0)
+		pr_fatal("%s: write error\n", output);
+	if (!quiet)
+		printf("%s: %.8s, %zu bytes of code, %zu bytes, "
+		       "checksum 0x%08X\n", output, magic, code_size, size, sum);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *cmd = argv[0], *magic = EGON_MAGIC_BT0;
+	unsigned long align = EGON_DEFAULT_ALIGN;
+	char *end;
+	int i;
+
+	for (argc--, argv++; argc > 0 && argv[0][0] == '-'; argc--, argv++) {
+		if (strcmp(argv[0], "-q") == 0) {
+			quiet = true;
+		} else if (strcmp(argv[0], "-1") == 0) {
+			magic = EGON_MAGIC_BT1;
+		} else if (strcmp(argv[0], "-a") == 0 && argc > 1) {
+			align = strtoul(argv[1], &end, 0);
+			if (*end || align < 4 || align % 4)
+				pr_fatal("Invalid alignment '%s'\n", argv[1]);
+			argc--, argv++;
+		} else {
+			usage(cmd);
+			return 1;
+		}
+	}
+	if (argc < 2) {
+		usage(cmd);
+		return 1;
+	}
+
+	if (strcmp(argv[0], "build") == 0) {
+		if (argc != 3) {
+			usage(cmd);
+			return 1;
+		}
+		return build_image(argv[1], argv[2], align, magic);
+	}
+	if (strcmp(argv[0], "verify") != 0 && strcmp(argv[0], "stamp") != 0) {
+		usage(cmd);
+		return 1;
+	}
+	for (i = 1; i < argc; i++)
+		process_path(argv[i], argv[0][0] == 's' ? CMD_STAMP
+							: CMD_VERIFY, false);
+
+	if (!quiet && count_ok + count_stamped + count_bad > 1)
+		printf("%u image(s): %u OK, %u stamped, %u invalid\n",
+		       count_ok + count_stamped + count_bad, count_ok,
+		       count_stamped, count_bad);
+	free(image);
+	return count_bad ? 1 : 0;
+}
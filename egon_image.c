@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2026  sunxi-tools developers
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**********************************************************************
+ * eGON boot file header checksums, shared by sunxi-fel, sunxi-egon and
+ * sunxi-bootinfo
+ *
+ * The sum runs on SSE2 (x86-64) or NEON (little-endian AArch64), both of
+ * which are part of the base instruction set there. Other hosts use a
+ * plain loop with independent accumulators.
+ **********************************************************************/
+#include "egon_image.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__SSE2__)
+#define EGON_SUM_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON) && !defined(__AARCH64EB__)
+#define EGON_SUM_NEON
+#include <arm_neon.h>
+#endif
+
+static uint32_t get_le32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | (uint32_t)p[1] << 8 |
+	       (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static void put_le32(uint8_t *p, uint32_t val)
+{
+	p[0] = val;
+	p[1] = val >> 8;
+	p[2] = val >> 16;
+	p[3] = val >> 24;
+}
+
+uint32_t egon_sum32(const void *data, size_t len)
+{
+	const uint8_t *p = data;
+	uint32_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+
+#if defined(EGON_SUM_SSE2)
+	__m128i v0 = _mm_setzero_si128(), v1 = v0, v2 = v0, v3 = v0;
+	uint32_t lane[4];
+
+	for (; len >= 64; p += 64, len -= 64) {
+		v0 = _mm_add_epi32(v0, _mm_loadu_si128((const __m128i *)p));
+		v1 = _mm_add_epi32(v1, _mm_loadu_si128((const __m128i *)(p + 16)));
+		v2 = _mm_add_epi32(v2, _mm_loadu_si128((const __m128i *)(p + 32)));
+		v3 = _mm_add_epi32(v3, _mm_loadu_si128((const __m128i *)(p + 48)));
+	}
+	v0 = _mm_add_epi32(_mm_add_epi32(v0, v1), _mm_add_epi32(v2, v3));
+	_mm_storeu_si128((__m128i *)lane, v0);
+	s0 = lane[0] + lane[1];
+	s1 = lane[2] + lane[3];
+#elif defined(EGON_SUM_NEON)
+	uint32x4_t v0 = vdupq_n_u32(0), v1 = v0, v2 = v0, v3 = v0;
+
+	for (; len >= 64; p += 64, len -= 64) {
+		v0 = vaddq_u32(v0, vreinterpretq_u32_u8(vld1q_u8(p)));
+		v1 = vaddq_u32(v1, vreinterpretq_u32_u8(vld1q_u8(p + 16)));
+		v2 = vaddq_u32(v2, vreinterpretq_u32_u8(vld1q_u8(p + 32)));
+		v3 = vaddq_u32(v3, vreinterpretq_u32_u8(vld1q_u8(p + 48)));
+	}
+	s0 = vaddvq_u32(vaddq_u32(vaddq_u32(v0, v1), vaddq_u32(v2, v3)));
+#endif
+	for (; len >= 16; p += 16, len -= 16) {
+		s0 += get_le32(p);
+		s1 += get_le32(p + 4);
+		s2 += get_le32(p + 8);
+		s3 += get_le32(p + 12);
+	}
+	for (; len >= 4; p += 4, len -= 4)
+		s0 += get_le32(p);
+
+	return s0 + s1 + s2 + s3;
+}
+
+const char *egon_magic(const void *image, size_t size)
+{
+	const char *magic = (const char *)image + EGON_MAGIC_OFFSET;
+
+	if (size < EGON_LENGTH_OFFSET + 4)
+		return NULL;
+	if (memcmp(magic, EGON_MAGIC_BT0, 8) == 0)
+		return EGON_MAGIC_BT0;
+	if (memcmp(magic, EGON_MAGIC_BT1, 8) == 0)
+		return EGON_MAGIC_BT1;
+	return NULL;
+}
+
+uint32_t egon_length(const void *image)
+{
+	return get_le32((const uint8_t *)image + EGON_LENGTH_OFFSET);
+}
+
+uint32_t egon_stored_checksum(const void *image)
+{
+	return get_le32((const uint8_t *)image + EGON_CHECKSUM_OFFSET);
+}
+
+egon_status_t egon_verify(const void *image, size_t size, uint32_t *computed)
+{
+	uint32_t length, stored, sum;
+
+	if (!egon_magic(image, size))
+		return EGON_NO_HEADER;
+	length = egon_length(image);
+	if (length > size || length < EGON_LENGTH_OFFSET + 4 || length % 4)
+		return EGON_BAD_LENGTH;
+
+	/* the sum has the stored value in place of EGON_STAMP_VALUE */
+	stored = egon_stored_checksum(image);
+	sum = egon_sum32(image, length) - stored + EGON_STAMP_VALUE;
+	if (computed)
+		*computed = sum;
+
+	return sum == stored ? EGON_OK : EGON_BAD_CHECKSUM;
+}
+
+const char *egon_status_str(egon_status_t status)
+{
+	switch (status) {
+	case EGON_OK:		return "OK";
+	case EGON_NO_HEADER:	return "no eGON header";
+	case EGON_BAD_LENGTH:	return "bad length in the eGON header";
+	case EGON_BAD_CHECKSUM:	return "checksum mismatch";
+	}
+	return "unknown error";
+}
+
+egon_status_t egon_stamp(void *image, size_t size)
+{
+	egon_status_t status;
+	uint32_t sum;
+
+	status = egon_verify(image, size, &sum);
+	if (status == EGON_BAD_CHECKSUM) {
+		put_le32((uint8_t *)image + EGON_CHECKSUM_OFFSET, sum);
+		status = EGON_OK;
+	}
+	return status;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2026  sunxi-tools developers
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _SUNXI_TOOLS_EGON_IMAGE_H
+#define _SUNXI_TOOLS_EGON_IMAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * eGON boot file header, as used by the BROM for SPL (boot0, "eGON.BT0")
+ * and by the legacy Allwinner boot1 ("eGON.BT1"). The checksum is the sum
+ * of all 32-bit little-endian words over 'length' bytes, calculated with
+ * the checksum field itself set to EGON_STAMP_VALUE.
+ */
+#define EGON_MAGIC_BT0		"eGON.BT0"
+#define EGON_MAGIC_BT1		"eGON.BT1"
+#define EGON_STAMP_VALUE	0x5F0A6C39
+
+#define EGON_MAGIC_OFFSET	4
+#define EGON_CHECKSUM_OFFSET	12
+#define EGON_LENGTH_OFFSET	16
+/* header size of new images, as laid out by U-Boot ("mkimage -T sunxi_egon") */
+#define EGON_HEADER_SIZE	0x60
+
+typedef enum {
+	EGON_OK,
+	EGON_NO_HEADER,		/* no eGON.BT0 / eGON.BT1 signature */
+	EGON_BAD_LENGTH,	/* length exceeds the data, or isn't word aligned */
+	EGON_BAD_CHECKSUM,
+} egon_status_t;
+
+/* sum of the little-endian 32-bit words in 'data', 'len' is rounded down */
+uint32_t egon_sum32(const void *data, size_t len);
+
+/* return the magic ("eGON.BT0" or "eGON.BT1") of 'image', or NULL */
+const char *egon_magic(const void *image, size_t size);
+uint32_t egon_length(const void *image);
+uint32_t egon_stored_checksum(const void *image);
+
+/*
+ * Check the header and checksum of 'image' (with 'size' bytes available).
+ * If 'computed' is given, it receives the correct checksum value (unless
+ * EGON_NO_HEADER or EGON_BAD_LENGTH get returned).
+ */
+egon_status_t egon_verify(const void *image, size_t size, uint32_t *computed);
+const char *egon_status_str(egon_status_t status);
+
+/* recalculate and store the checksum, the header must be valid */
+egon_status_t egon_stamp(void *image, size_t size);
+
+#endif /* _SUNXI_TOOLS_EGON_IMAGE_H */
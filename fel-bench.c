@@ -0,0 +1,425 @@
+/*
+ * Copyright (C) 2026  sunxi-tools developers
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**********************************************************************
+ * FEL transfer benchmarks ("bench" command)
+ **********************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "portable_endian.h"
+#include "fel-bench.h"
+#include "version.h"
+
+#define BENCH_LATENCY_RUNS	100	/* repetitions for latency tests */
+#define BENCH_MIN_TIME		0.25	/* min. seconds per throughput test */
+#define BENCH_MAX_RUNS		1000	/* max. repetitions per test */
+#define BENCH_MIN_SIZE		64	/* smallest transfer size */
+
+typedef struct {
+	double min, sum, max;
+	unsigned int count;
+} bench_latency_t;
+
+/* collected CSV lines, printed after the table */
+#define BENCH_MAX_LINES		64
+static char bench_csv[BENCH_MAX_LINES][80];
+static unsigned int bench_csv_lines;
+
+#define bench_csv_add(...) \
+	do { \
+		if (bench_csv_lines < BENCH_MAX_LINES) \
+			snprintf(bench_csv[bench_csv_lines++], \
+				 sizeof(bench_csv[0]), __VA_ARGS__); \
+	} while (0)
+
+static void latency_add(bench_latency_t *lat, double seconds)
+{
+	if (lat->count == 0 || seconds < lat->min)
+		lat->min = seconds;
+	if (seconds > lat->max)
+		lat->max = seconds;
+	lat->sum += seconds;
+	lat->count++;
+}
+
+static void latency_print(const char *name, const bench_latency_t *lat)
+{
+	printf("  %-16s %10.1f %10.1f %10.1f\n", name, lat->min * 1e6,
+	       lat->sum / lat->count * 1e6, lat->max * 1e6);
+	bench_csv_add("bench,latency,%s,%.1f,%.1f,%.1f", name, lat->min * 1e6,
+		lat->sum / lat->count * 1e6, lat->max * 1e6);
+}
+
+/*
+ * The SRAM area that the SPL would get loaded to, up to the first BROM
+ * buffer. The BROM doesn't rely on its content, so we may use it for
+ * the throughput tests (saving and restoring it anyway).
+ */
+static size_t bench_sram_size(const feldev_handle *dev)
+{
+	const soc_info_t *soc = dev->soc_info;
+	uint32_t end = soc->thunk_addr;
+	sram_swap_buffers *swap;
+
+	if (soc->sram_size && soc->spl_addr + soc->sram_size < end)
+		end = soc->spl_addr + soc->sram_size;
+	for (swap = soc->swap_buffers; swap && swap->size; swap++)
+		if (swap->buf1 >= soc->spl_addr && swap->buf1 < end)
+			end = swap->buf1;
+	/* the translation tables (SPL flow, or --mmu) must stay */
+	if (soc->mmu_tt_addr >= soc->spl_addr && soc->mmu_tt_addr < end)
+		end = soc->mmu_tt_addr;
+	if (dev->mmu_tt_addr >= soc->spl_addr && dev->mmu_tt_addr < end)
+		end = dev->mmu_tt_addr;
+	return end - soc->spl_addr;
+}
+
+/* latency of single requests and of the typical thunk operations */
+static void bench_latency(feldev_handle *dev)
+{
+	soc_info_t *soc = dev->soc_info;
+	uint32_t arm_code[12] = {
+		htole32(0xe12fff1e), /* bx lr */
+	};
+	bench_latency_t read4 = { 0 }, write4 = { 0 }, readl = { 0 };
+	bench_latency_t writel = { 0 }, exec = { 0 }, thunk = { 0 };
+	uint32_t value;
+	double start;
+	int i;
+
+	aw_fel_write(dev, arm_code, soc->scratch_addr, sizeof(arm_code));
+	aw_fel_flush(dev);
+	for (i = 0; i < BENCH_LATENCY_RUNS; i++) {
+		start = gettime();
+		aw_fel_read(dev, soc->spl_addr, &value, sizeof(value));
+		latency_add(&read4, gettime() - start);
+
+		start = gettime();
+		aw_fel_write_buffer(dev, &value, soc->spl_addr,
+				    sizeof(value), false);
+		latency_add(&write4, gettime() - start);
+
+		start = gettime();
+		aw_fel_execute(dev, soc->scratch_addr);
+		latency_add(&exec, gettime() - start);
+
+		/* a typical small thunk (the readl_n/writel_n size) */
+		start = gettime();
+		aw_fel_write(dev, arm_code, soc->scratch_addr,
+			     sizeof(arm_code));
+		aw_fel_flush(dev);
+		latency_add(&thunk, gettime() - start);
+
+		start = gettime();
+		fel_readl_n(dev, soc->spl_addr, &value, 1);
+		latency_add(&readl, gettime() - start);
+
+		start = gettime();
+		fel_writel_n(dev, soc->spl_addr, &value, 1);
+		latency_add(&writel, gettime() - start);
+	}
+
+	printf("Latency (usec)              min        avg        max\n");
+	latency_print("read (4 bytes)", &read4);
+	latency_print("write (4 bytes)", &write4);
+	latency_print("exec", &exec);
+	latency_print("thunk upload", &thunk);
+	latency_print("readl", &readl);
+	latency_print("writel", &writel);
+}
+
+/* run one direction of a throughput test, returning bytes per second */
+static double bench_transfer(feldev_handle *dev, uint32_t addr, void *buf,
+			     size_t size, bool write)
+{
+	unsigned int runs = 0;
+	double start = gettime(), elapsed;
+
+	do {
+		if (write)
+			aw_fel_write_buffer(dev, buf, addr, size, false);
+		else
+			aw_fel_read(dev, addr, buf, size);
+		runs++;
+		elapsed = gettime() - start;
+	} while ((runs < 2 || elapsed < BENCH_MIN_TIME) &&
+		 runs < BENCH_MAX_RUNS);
+
+	return elapsed > 0. ? (double)size * runs / elapsed : 0.;
+}
+
+/* sweep over transfer sizes (powers of 4), up to the region size */
+static void bench_throughput(feldev_handle *dev, const char *name,
+			     uint32_t addr, size_t region_size)
+{
+	uint8_t *buf = malloc(region_size);
+	size_t size;
+
+	if (!buf) {
+		fprintf(stderr, "FAILED to allocate benchmark buffer.\n");
+		exit(1);
+	}
+	for (size = 0; size < region_size; size++)
+		buf[size] = size * 7;
+
+	for (size = BENCH_MIN_SIZE; size <= region_size; size *= 4) {
+		double wr = bench_transfer(dev, addr, buf, size, true);
+		double rd = bench_transfer(dev, addr, buf, size, false);
+
+		printf("  %-6s %10zu %12.1f %12.1f\n", name, size,
+		       wr / 1024., rd / 1024.);
+		bench_csv_add("bench,throughput,%s,%zu,%.0f,%.0f", name, size,
+			      wr, rd);
+		if (size * 4 > region_size && size < region_size)
+			size = region_size / 4; /* last step: full region */
+	}
+	free(buf);
+}
+
+/*
+ * "bench" command: measure request latencies and SRAM throughput. If a
+ * DRAM (or other) region is given (addr and size non-zero), sweep that
+ * as well. Results go to stdout as a table, followed by CSV lines that
+ * start with "bench," for automated processing.
+ */
+void aw_fel_bench(feldev_handle *dev, uint32_t addr, size_t size)
+{
+	soc_info_t *soc = dev->soc_info;
+	size_t sram_size = bench_sram_size(dev);
+	unsigned int i;
+	void *backup;
+
+	bench_csv_lines = 0;
+	printf("FEL benchmark, SoC %s (0x%04X), sunxi-tools %s\n",
+	       dev->soc_name, dev->soc_version.soc_id, VERSION);
+	bench_csv_add("bench,info,%s,0x%04x,%s", dev->soc_name,
+		      dev->soc_version.soc_id, VERSION);
+
+	backup = malloc(sram_size);
+	if (!backup) {
+		fprintf(stderr, "FAILED to allocate SRAM backup buffer.\n");
+		exit(1);
+	}
+	aw_fel_read(dev, soc->spl_addr, backup, sram_size);
+
+	bench_latency(dev);
+
+	printf("Throughput (KiB/sec)\n"
+	       "  region       size        write         read\n");
+	bench_throughput(dev, "sram", soc->spl_addr, sram_size);
+	aw_fel_write_buffer(dev, backup, soc->spl_addr, sram_size, false);
+	free(backup);
+
+	if (size > 0)
+		bench_throughput(dev, "dram", addr, size);
+
+	putchar('\n');
+	for (i = 0; i < bench_csv_lines; i++)
+		puts(bench_csv[i]);
+}
+
+/**********************************************************************
+ * On-device memory benchmark ("membench" command)
+ **********************************************************************/
+
+/* kernels of the membench thunk, see thunks/membench.S */
+enum {
+	MB_READ, MB_WRITE, MB_COPY, MB_CHASE,
+	MB_NEON_READ, MB_NEON_WRITE, MB_NEON_COPY, MB_CHASE_INIT,
+};
+#define MB_USE_PMU		0x100	/* time with PMCCNTR instead of CNTPCT */
+#define MB_STACK_SIZE		40
+#define MB_TARGET_TIME		0.1	/* device seconds per measurement */
+#define MB_CHASE_MIN		4096	/* smallest pointer chase block */
+#define MB_DRAM_BASE		0x40000000
+
+typedef struct {
+	feldev_handle *dev;
+	uint32_t flags;		/* MB_USE_PMU or 0 */
+	double freq;		/* counter ticks per second */
+} membench_t;
+
+/* run a kernel once, returning the elapsed counter ticks */
+static uint32_t membench_run(membench_t *mb, uint32_t op, uint32_t addr,
+			     uint32_t size, uint32_t loops)
+{
+	uint32_t arm_code[] = {
+		#include "thunks/membench.h"
+	};
+	uint32_t args[] = { op | mb->flags, addr, size, loops };
+	uint32_t ticks;
+
+	aw_fel_remotefunc_prepare(mb->dev, MB_STACK_SIZE, arm_code,
+				  sizeof(arm_code), 4, args);
+	aw_fel_remotefunc_execute(mb->dev, &ticks);
+	return ticks;
+}
+
+/*
+ * The PMU cycle counter runs at the (unknown) CPU clock. Calibrate it
+ * against the host clock, using the difference between two runs of
+ * the read kernel (which cancels out the USB overhead).
+ */
+static double membench_calibrate(membench_t *mb, uint32_t addr)
+{
+	uint32_t loops = 1, c1, c2;
+	double t1, t2, start;
+
+	do {
+		loops *= 4;
+		start = gettime();
+		c1 = membench_run(mb, MB_READ, addr, 4096, loops);
+		t1 = gettime() - start;
+	} while (t1 < 0.05 && loops < (1U << 24));
+	start = gettime();
+	c2 = membench_run(mb, MB_READ, addr, 4096, loops * 4);
+	t2 = gettime() - start;
+	if (c2 <= c1 || t2 <= t1)
+		pr_fatal("membench: failed to calibrate the cycle counter\n");
+	return (c2 - c1) / (t2 - t1);
+}
+
+/*
+ * Run a kernel with a loop count that takes about MB_TARGET_TIME on the
+ * device, returning the time in seconds. 'granularity' is the minimum
+ * loop count (and step) the kernel supports.
+ */
+static double membench_measure(membench_t *mb, uint32_t op, uint32_t addr,
+			       uint32_t size, uint32_t *loops,
+			       uint32_t granularity)
+{
+	uint32_t ticks, target = MB_TARGET_TIME * mb->freq;
+	double scale;
+
+	*loops = granularity;
+	for (;;) {
+		ticks = membench_run(mb, op, addr, size, *loops);
+		if (ticks >= target / 2 || *loops >= (1U << 30) / granularity)
+			break;
+		scale = ticks ? (double)target / ticks : 64.;
+		if (scale > 64.)
+			scale = 64.;
+		*loops = (uint32_t)(*loops * scale + granularity - 1)
+			 / granularity * granularity;
+	}
+	return ticks / mb->freq;
+}
+
+static void membench_bandwidth(membench_t *mb, const char *name, uint32_t op,
+			       uint32_t addr, uint32_t size)
+{
+	uint32_t loops;
+	double seconds = membench_measure(mb, op, addr, size, &loops, 1);
+	/* "copy" transfers half the buffer per pass */
+	double bytes = (double)loops *
+		       (op == MB_COPY || op == MB_NEON_COPY ? size / 2 : size);
+
+	printf("  %-20s %10.3f GB/s\n", name, bytes / seconds / 1e9);
+}
+
+static void membench_latency(membench_t *mb, uint32_t addr, uint32_t size)
+{
+	uint32_t loops;
+	double seconds;
+
+	membench_run(mb, MB_CHASE_INIT, addr, size, 0);
+	seconds = membench_measure(mb, MB_CHASE, addr, size, &loops, 8);
+	printf("  %10u bytes %12.1f ns\n", size, seconds / loops * 1e9);
+}
+
+/*
+ * "membench" command: run memory bandwidth (sequential read, write and
+ * copy, using LDM/STM and NEON) and latency (pointer chase) kernels on
+ * the device, for the given memory region (usually DRAM, after "spl").
+ * The region gets overwritten.
+ */
+void aw_fel_membench(feldev_handle *dev, uint32_t addr, uint32_t size)
+{
+	soc_info_t *soc = dev->soc_info;
+	membench_t mb = { .dev = dev };
+	uint32_t midr, sctlr, cpacr, chase_size, block;
+	bool neon;
+
+	if (addr & 63)
+		pr_fatal("membench: address 0x%08X not 64-byte aligned\n", addr);
+	size &= ~127U;
+	if (size < MB_CHASE_MIN)
+		pr_fatal("membench: region too small (min. %u bytes)\n",
+			 MB_CHASE_MIN);
+	/*
+	 * The SRAM holds the thunks and their stack, remote functions, the
+	 * BROM's swap buffers and possibly the MMU table, so stay in DRAM.
+	 */
+	if (addr < MB_DRAM_BASE || size > 0xFFFFFFFFU - addr + 1)
+		pr_fatal("membench: region 0x%08X+0x%X is not within DRAM "
+			 "(0x%08X and up)\n", addr, size, MB_DRAM_BASE);
+
+	midr = aw_read_arm_cp_reg(dev, soc, 15, 0, 0, 0, 0);
+	if (((midr >> 16) & 0xf) != 0xf)
+		pr_fatal("membench: needs an ARMv7 (or later) core, MIDR is 0x%08X\n",
+			 midr);
+	sctlr = aw_read_arm_cp_reg(dev, soc, 15, 0, 1, 0, 0);
+
+	/* VFP/NEON present, if access to cp10/cp11 can be enabled */
+	cpacr = aw_read_arm_cp_reg(dev, soc, 15, 0, 1, 0, 2);
+	aw_write_arm_cp_reg(dev, soc, 15, 0, 1, 0, 2, cpacr | (0xf << 20));
+	neon = (aw_read_arm_cp_reg(dev, soc, 15, 0, 1, 0, 2) &
+		(1U << 31 | 0xf << 20)) == 0xf << 20; /* ASEDIS clear */
+	aw_write_arm_cp_reg(dev, soc, 15, 0, 1, 0, 2, cpacr);
+
+	/* prefer the generic timer, if it exists and is actually running */
+	if ((aw_read_arm_cp_reg(dev, soc, 15, 0, 0, 1, 1) >> 16) & 0xf) {
+		mb.freq = aw_read_arm_cp_reg(dev, soc, 15, 0, 14, 0, 0);
+		if (mb.freq == 0)
+			mb.freq = 24000000; /* sunxi: 24 MHz oscillator */
+		if (membench_run(&mb, MB_READ, addr, 4096, 16) == 0)
+			mb.freq = 0;
+	}
+	if (mb.freq == 0) {
+		mb.flags = MB_USE_PMU;
+		mb.freq = membench_calibrate(&mb, addr);
+	}
+
+	printf("Memory benchmark at 0x%08X, %u bytes (SoC %s, MIDR 0x%08X)\n",
+	       addr, size, dev->soc_name, midr);
+	printf("MMU %s, D-cache %s, I-cache %s, timer: %s at %.3f MHz\n",
+	       sctlr & 1 ? "on" : "off", sctlr & 4 ? "on" : "off",
+	       sctlr & (1 << 12) ? "on" : "off",
+	       mb.flags & MB_USE_PMU ? "PMU cycle counter" : "generic timer",
+	       mb.freq / 1e6);
+
+	printf("Bandwidth\n");
+	membench_bandwidth(&mb, "read (LDM)", MB_READ, addr, size);
+	membench_bandwidth(&mb, "write (STM)", MB_WRITE, addr, size);
+	membench_bandwidth(&mb, "copy (LDM/STM)", MB_COPY, addr, size);
+	if (neon) {
+		membench_bandwidth(&mb, "read (NEON)", MB_NEON_READ, addr, size);
+		membench_bandwidth(&mb, "write (NEON)", MB_NEON_WRITE, addr, size);
+		membench_bandwidth(&mb, "copy (NEON)", MB_NEON_COPY, addr, size);
+	}
+
+	/* the pointer chase needs a power of two block size */
+	for (chase_size = MB_CHASE_MIN; chase_size * 2 <= size; chase_size *= 2)
+		;
+	printf("Latency (random pointer chase)\n");
+	for (block = MB_CHASE_MIN; block < chase_size; block *= 16)
+		membench_latency(&mb, addr, block);
+	membench_latency(&mb, addr, chase_size);
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2026  sunxi-tools developers
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**********************************************************************
+ * Large on-device copies and fills with the DMA controller
+ **********************************************************************/
+#include <stdio.h>
+
+#include "common.h"
+#include "portable_endian.h"
+#include "fel-dma.h"
+
+/*
+ * Below this size, the CPU copy is fast enough, and avoids the setup cost.
+ * The DMA engine is also only used within DRAM, to stay clear of MMIO.
+ */
+#define DMA_MIN_SIZE		(64 * 1024)
+#define DMA_DRAM_BASE		0x40000000
+
+/* channel configuration (for source and destination) */
+#define DMA_CFG_DRQ_SDRAM	1
+#define DMA_CFG_BURST_8_A31	(1 << 7)
+#define DMA_CFG_BURST_8_H3	(2 << 6)
+#define DMA_CFG_WIDTH_32	(2 << 9)
+#define DMA_CFG(x)		((x) | ((x) << 16))
+
+#define DMA_AUTOGATE_DISABLE	4
+
+/* ungate and deassert the reset of the DMA controller */
+static void dma_enable(feldev_handle *dev, const dma_info *dma)
+{
+	fel_setbits_le32(dev, dma->gate_reg, 1U << dma->gate_bit);
+	fel_setbits_le32(dev, dma->reset_reg, 1U << dma->reset_bit);
+	if (dma->mbus_gate_reg)
+		fel_setbits_le32(dev, dma->mbus_gate_reg,
+				 1U << dma->mbus_gate_bit);
+	if (dma->autogate_reg) {
+		uint32_t val = DMA_AUTOGATE_DISABLE;
+		fel_writel_n(dev, dma->base + dma->autogate_reg, &val, 1);
+	}
+}
+
+static bool in_dram(uint32_t addr, size_t size)
+{
+	return addr >= DMA_DRAM_BASE && size <= 0xFFFFFFFFU - addr + 1;
+}
+
+/* run a DMA transfer (a fill if 'src_addr' is 0) on the device */
+static bool dma_xfer(feldev_handle *dev, uint32_t dst_addr, uint32_t src_addr,
+		     uint32_t pattern, size_t size)
+{
+	uint32_t dma_xfer_code[] = {
+		#include "thunks/dma.h"
+	};
+	const dma_info *dma = dev->soc_info ? dev->soc_info->dma : NULL;
+	uint32_t cfg, result = 1;
+	int handle;
+
+	if (!dma || size < DMA_MIN_SIZE || size > 0xFFFFFFFFU ||
+	    ((dst_addr | src_addr | size) & 3) || !in_dram(dst_addr, size) ||
+	    (src_addr && !in_dram(src_addr, size)))
+		return false;
+
+	cfg = DMA_CFG(DMA_CFG_DRQ_SDRAM | DMA_CFG_WIDTH_32 |
+		      (dma->burst_h3 ? DMA_CFG_BURST_8_H3 : DMA_CFG_BURST_8_A31));
+	uint32_t args[] = { dma->base, cfg, dst_addr, src_addr, size, pattern };
+
+	aw_fel_device_write(dev, dst_addr, size);
+	dma_enable(dev, dma);
+	handle = aw_fel_remotefunc_load(dev, 64, dma_xfer_code,
+					sizeof(dma_xfer_code), ARRAY_SIZE(args));
+	if (handle < 0 ||
+	    !aw_fel_remotefunc_call(dev, handle, args, &result)) {
+		/* no room in the code area, use the scratch area instead */
+		aw_fel_remotefunc_prepare(dev, 64, dma_xfer_code,
+					  sizeof(dma_xfer_code),
+					  ARRAY_SIZE(args), args);
+		aw_fel_remotefunc_execute(dev, &result);
+	}
+	if (result != 0) {
+		pr_error("DMA transfer timed out, falling back to the CPU\n");
+		return false;
+	}
+	return true;
+}
+
+/*
+ * Copy (non-overlapping) data within DRAM, using the DMA controller. Returns
+ * false if that's not possible or not worth it (too small, not 32-bit
+ * aligned, unsupported SoC), so the caller should use the CPU instead.
+ */
+bool aw_fel_dma_copy(feldev_handle *dev,
+		     uint32_t dst_addr, uint32_t src_addr, size_t size)
+{
+	if (src_addr == 0 || (dst_addr < src_addr + size &&
+			      src_addr < dst_addr + size))
+		return false;
+	return dma_xfer(dev, dst_addr, src_addr, 0, size);
+}
+
+/* Fill DRAM with a 32-bit pattern, with the same restrictions as above */
+bool aw_fel_dma_fill(feldev_handle *dev,
+		     uint32_t dst_addr, uint32_t pattern, size_t size)
+{
+	return dma_xfer(dev, dst_addr, 0, pattern, size);
+}
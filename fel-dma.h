@@ -0,0 +1,27 @@
+/*
+ * Copyright (C) 2026  sunxi-tools developers
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _SUNXI_TOOLS_FEL_DMA_H
+#define _SUNXI_TOOLS_FEL_DMA_H
+
+#include "fel_lib.h"
+
+bool aw_fel_dma_copy(feldev_handle *dev,
+		     uint32_t dst_addr, uint32_t src_addr, size_t size);
+bool aw_fel_dma_fill(feldev_handle *dev,
+		     uint32_t dst_addr, uint32_t pattern, size_t size);
+
+#endif /* _SUNXI_TOOLS_FEL_DMA_H */
@@ -39,6 +39,12 @@ if ARGV.size < 2
 
   printf("If the returned result is not needed (a void function), then the second\n")
   printf("argument to the 'aw_fel_remotefunc_execute' function can be NULL.\n\n")
+
+  printf("Alternatively, the function can stay loaded on the device next to other\n")
+  printf("functions, so that each call only needs to upload the arguments:\n")
+  printf("\n")
+  printf("    if (!aw_fel_remotefunc_call_sum(dev, a, b, &c))\n")
+  printf("        ... (no room in the code area, fall back to the above)\n\n")
   exit(1)
 end
 
@@ -121,14 +127,10 @@ out = File.open(ARGV[1], "w")
 
 out.printf("/* Automatically generated, do not edit! */\n\n")
 
-out.printf("static void\n")
-funcdecl = sprintf("aw_fel_remotefunc_prepare_#{function_name}(feldev_handle *dev,")
-out.printf("%s\n", funcdecl)
-out.printf("%s", function_args.map {|a|
-           " " * funcdecl.index("(") + " uint32_t              " + a }.join(",\n"))
-out.printf(")\n{\n")
+arm_code = "#{function_name}_arm_code"
+stack_size = stack_usage[0][:stack_usage]
 
-out.printf("\tstatic uint8_t arm_code[] = {\n")
+out.printf("static uint8_t %s[] = {\n", arm_code)
 `#{toolchain}objdump -d #{ARGV[0]}.o`.each_line {|l|
     next unless l =~ /(\h+)\:\s+(\h+)\s+(\S+)\s+([^;]*)/
     addr   = $1
@@ -136,14 +138,42 @@ out.printf("\tstatic uint8_t arm_code[] = {\n")
     p1     = $3
     p2     = $4.strip
     opcode = opcode.scan(/../).map {|a| "0x" + a }.reverse.join(", ")
-    out.printf("\t\t%s, /* %4s:    %-8s %-34s \x2a/\n", opcode, addr, p1, p2)
+    out.printf("\t%s, /* %4s:    %-8s %-34s \x2a/\n", opcode, addr, p1, p2)
 }
-out.printf("\t};\n")
+out.printf("};\n\n")
+
+# Upload the function to the scratch area, see aw_fel_remotefunc_prepare()
+out.printf("static void\n")
+funcdecl = sprintf("aw_fel_remotefunc_prepare_#{function_name}(feldev_handle *dev,")
+out.printf("%s\n", funcdecl)
+out.printf("%s", function_args.map {|a|
+           " " * funcdecl.index("(") + " uint32_t              " + a }.join(",\n"))
+out.printf(")\n{\n")
 
 out.printf("\tuint32_t args[] = {\n\t\t")
 out.printf("%s\n\t};\n", function_args.join(",\n\t\t"))
 
-out.printf("\taw_fel_remotefunc_prepare(dev, %d, arm_code, sizeof(arm_code), %d, args);\n",
-           stack_usage[0][:stack_usage], function_args.size)
+out.printf("\taw_fel_remotefunc_prepare(dev, %d, %s,\n", stack_size, arm_code)
+out.printf("\t\t\t\t  sizeof(%s), %d, args);\n", arm_code, function_args.size)
+
+out.printf("}\n\n")
+
+# Call the function, loading it into the code area on first use (see
+# aw_fel_remotefunc_load). Returns false if it doesn't fit there.
+out.printf("static bool\n")
+funcdecl = sprintf("aw_fel_remotefunc_call_#{function_name}(feldev_handle *dev,")
+call_args = function_args.map {|a| "uint32_t              " + a }
+call_args.push("uint32_t             *retval") if have_retval
+out.printf("%s\n", funcdecl)
+out.printf("%s", call_args.map {|a| " " * funcdecl.index("(") + " " + a }.join(",\n"))
+out.printf(")\n{\n")
+
+out.printf("\tint handle = aw_fel_remotefunc_load(dev, %d, %s,\n", stack_size, arm_code)
+out.printf("\t\t\t\t\t    sizeof(%s), %d);\n", arm_code, function_args.size)
+out.printf("\tuint32_t args[] = {\n\t\t")
+out.printf("%s\n\t};\n", function_args.join(",\n\t\t"))
+out.printf("\treturn handle >= 0 &&\n")
+out.printf("\t       aw_fel_remotefunc_call(dev, handle, args, %s);\n",
+           have_retval ? "retval" : "NULL")
 
 out.printf("}\n")
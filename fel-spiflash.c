@@ -343,31 +343,34 @@ static void restore_sram(feldev_handle *dev, void *buf)
 	free(buf);
 }
 
-static void prepare_spi_batch_data_transfer(feldev_handle *dev, uint32_t buf)
+/*
+ * Run the batch data transfer code on the device, processing the commands
+ * in 'buf'. The code stays loaded in the remote function area, so it's
+ * uploaded just once. If there is no room there, fall back to preparing it
+ * in the scratch area each time.
+ */
+static void spi_batch_data_transfer(feldev_handle *dev, uint32_t buf)
 {
-	if (spi_is_sun6i(dev)) {
-		aw_fel_remotefunc_prepare_spi_batch_data_transfer(dev,
-							    buf,
-							    SUN6I_SPI0_TCR,
-							    SUN6I_TCR_XCH,
-							    SUN6I_SPI0_FIFO_STA,
-							    SUN6I_SPI0_TXD,
-							    SUN6I_SPI0_RXD,
-							    SUN6I_SPI0_MBC,
-							    SUN6I_SPI0_MTC,
-							    SUN6I_SPI0_BCC);
-	} else {
-		aw_fel_remotefunc_prepare_spi_batch_data_transfer(dev,
-							    buf,
-							    SUN4I_SPI0_CTL,
-							    SUN4I_CTL_XCH,
-							    SUN4I_SPI0_FIFO_STA,
-							    SUN4I_SPI0_TX,
-							    SUN4I_SPI0_RX,
-							    SUN4I_SPI0_BC,
-							    SUN4I_SPI0_TC,
-							    0);
-	}
+	const struct {
+		uint32_t ctl, xch, fifo_sta, tx, rx, bc, tc, bcc;
+	} sun4i_regs = {
+		SUN4I_SPI0_CTL, SUN4I_CTL_XCH, SUN4I_SPI0_FIFO_STA,
+		SUN4I_SPI0_TX, SUN4I_SPI0_RX, SUN4I_SPI0_BC, SUN4I_SPI0_TC, 0
+	}, sun6i_regs = {
+		SUN6I_SPI0_TCR, SUN6I_TCR_XCH, SUN6I_SPI0_FIFO_STA,
+		SUN6I_SPI0_TXD, SUN6I_SPI0_RXD, SUN6I_SPI0_MBC, SUN6I_SPI0_MTC,
+		SUN6I_SPI0_BCC
+	}, *r = spi_is_sun6i(dev) ? &sun6i_regs : &sun4i_regs;
+
+	if (aw_fel_remotefunc_call_spi_batch_data_transfer(dev, buf,
+			r->ctl, r->xch, r->fifo_sta, r->tx, r->rx,
+			r->bc, r->tc, r->bcc))
+		return;
+
+	aw_fel_remotefunc_prepare_spi_batch_data_transfer(dev, buf,
+			r->ctl, r->xch, r->fifo_sta, r->tx, r->rx,
+			r->bc, r->tc, r->bcc);
+	aw_fel_remotefunc_execute(dev, NULL);
 }
 
 /*
@@ -390,8 +393,6 @@ void aw_fel_spiflash_read(feldev_handle *dev,
 	if (!spi0_init(dev))
 		return;
 
-	prepare_spi_batch_data_transfer(dev, soc_info->spl_addr);
-
 	progress_start(progress, len);
 	while (len > 0) {
 		size_t chunk_size = len;
@@ -410,7 +411,7 @@ void aw_fel_spiflash_read(feldev_handle *dev,
 			aw_fel_write(dev, cmdbuf, soc_info->spl_addr, 6);
 		else
 			aw_fel_write(dev, cmdbuf, soc_info->spl_addr, chunk_size + 8);
-		aw_fel_remotefunc_execute(dev, NULL);
+		spi_batch_data_transfer(dev, soc_info->spl_addr);
 		aw_fel_read(dev, soc_info->spl_addr + 6, buf8, chunk_size);
 
 		len -= chunk_size;
@@ -444,8 +445,6 @@ void aw_fel_spiflash_write_helper(feldev_handle *dev,
 	uint8_t *cmdbuf = malloc(max_chunk_size);
 	cmd_idx = 0;
 
-	prepare_spi_batch_data_transfer(dev, soc_info->spl_addr);
-
 	while (len > 0) {
 		while (len > 0 && max_chunk_size - cmd_idx > program_size + 64) {
 			if (offset % erase_size == 0) {
@@ -493,7 +492,7 @@ void aw_fel_spiflash_write_helper(feldev_handle *dev,
 
 		/* Flush */
 		aw_fel_write(dev, cmdbuf, soc_info->spl_addr, cmd_idx);
-		aw_fel_remotefunc_execute(dev, NULL);
+		spi_batch_data_transfer(dev, soc_info->spl_addr);
 		cmd_idx = 0;
 	}
 
@@ -564,8 +563,7 @@ void aw_fel_spiflash_info(feldev_handle *dev)
 		return;
 
 	aw_fel_write(dev, buf, soc_info->spl_addr, sizeof(buf));
-	prepare_spi_batch_data_transfer(dev, soc_info->spl_addr);
-	aw_fel_remotefunc_execute(dev, NULL);
+	spi_batch_data_transfer(dev, soc_info->spl_addr);
 	aw_fel_read(dev, soc_info->spl_addr, buf, sizeof(buf));
 
 	restore_sram(dev, backup);
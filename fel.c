@@ -20,6 +20,13 @@
 #include "fel_lib.h"
 #include "fel-spiflash.h"
 #include "fit_image.h"
+#include "pipeline.h"
+#include "fel_stats.h"
+#include "fel-bench.h"
+#include "fel-dma.h"
+#include "crc32.h"
+#include "egon_image.h"
+#include "artifact_cache.h"
 
 #include <assert.h>
 #include <ctype.h>
@@ -29,12 +36,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
-#include <zlib.h>
 #include <sys/stat.h>
 
 bool verbose = false; /* If set, makes the 'fel' tool more talkative */
 static uint32_t uboot_entry = 0; /* entry point (address) of U-Boot */
-static uint32_t uboot_size  = 0; /* size of U-Boot binary */
+/* memory used by U-Boot: the legacy image, or all images of a FIT */
+static const fit_range_t *uboot_ranges;
+static unsigned int uboot_range_count;
+static fit_range_t uboot_legacy_range;
 static bool enter_in_aarch64 = false;
 
 /* printf-style output, but only if "verbose" flag is active */
@@ -44,6 +53,7 @@ static bool enter_in_aarch64 = false;
 /* Constants taken from ${U-BOOT}/include/image.h */
 #define IH_MAGIC	0x27051956	/* Image Magic Number	*/
 #define IH_ARCH_ARM		2	/* ARM			*/
+#define IH_OS_LINUX		5	/* Linux		*/
 #define IH_TYPE_INVALID		0	/* Invalid Image	*/
 #define IH_TYPE_FIRMWARE	5	/* Firmware Image	*/
 #define IH_TYPE_SCRIPT		6	/* Script file		*/
@@ -119,6 +129,22 @@ void aw_fel_print_version(feldev_handle *dev)
 		buf.scratchpad, buf.pad[0], buf.pad[1]);
 }
 
+/* safeguard against overwriting an already loaded U-Boot binary */
+static void check_uboot_overlap(uint32_t offset, size_t len)
+{
+	const fit_range_t *r;
+	unsigned int i;
+
+	for (i = 0; i < uboot_range_count; i++) {
+		r = &uboot_ranges[i];
+		if (offset <= r->addr + r->size && offset + len >= r->addr)
+			pr_fatal("ERROR: Attempt to overwrite U-Boot! "
+				 "Request 0x%08X-0x%08X overlaps 0x%08X-0x%08X.\n",
+				 offset, (uint32_t)(offset + len),
+				 r->addr, r->addr + r->size);
+	}
+}
+
 /*
  * This wrapper for the FEL write functionality safeguards against overwriting
  * an already loaded U-Boot binary.
@@ -127,41 +153,126 @@ void aw_fel_print_version(feldev_handle *dev)
 double aw_write_buffer(feldev_handle *dev, void *buf, uint32_t offset,
 		       size_t len, bool progress)
 {
-	/* safeguard against overwriting an already loaded U-Boot binary */
-	if (uboot_size > 0 && offset <= uboot_entry + uboot_size
-			   && offset + len >= uboot_entry)
-		pr_fatal("ERROR: Attempt to overwrite U-Boot! "
-			 "Request 0x%08X-0x%08X overlaps 0x%08X-0x%08X.\n",
-			 offset, (uint32_t)(offset + len),
-			 uboot_entry, uboot_entry + uboot_size);
+	check_uboot_overlap(offset, len);
 
 	double start = gettime();
 	aw_fel_write_buffer(dev, buf, offset, len, progress);
 	return gettime() - start;
 }
 
-void hexdump(void *data, uint32_t offset, size_t size)
+/*
+ * Hexdump formatting. Lines get rendered with the help of lookup tables into
+ * a large output buffer, which is written out only when (nearly) full. This
+ * way dumping megabytes of memory isn't limited by per-character stdio calls.
+ *
+ * 'group' selects the number of bytes per displayed unit: 1 is the classic
+ * byte-wise format, 2 and 4 show little-endian 16/32-bit words (like
+ * "xxd -e"). Bytes beyond 'size' are shown as "__".
+ */
+#define HEXDUMP_BUFSIZE		(64 * 1024)
+#define HEXDUMP_MAX_LINE	96 /* upper limit for a single line */
+
+static struct {
+	char hex[256][2];	/* two hex digits per byte value */
+	char ascii[256];	/* printable representation */
+	bool initialized;
+	char out[HEXDUMP_BUFSIZE];
+	size_t used;
+} hexfmt;
+
+static void hexdump_init(void)
 {
-	size_t j;
-	unsigned char *buf = data;
-	for (j = 0; j < size; j+=16) {
-		size_t i;
-		printf("%08zx: ", offset + j);
+	static const char digits[] = "0123456789abcdef";
+	int i;
+
+	for (i = 0; i < 256; i++) {
+		hexfmt.hex[i][0] = digits[i >> 4];
+		hexfmt.hex[i][1] = digits[i & 15];
+		hexfmt.ascii[i] = isprint(i) ? i : '.';
+	}
+	hexfmt.initialized = true;
+}
+
+static void hexdump_flush(void)
+{
+	if (hexfmt.used > 0) {
+		fwrite(hexfmt.out, 1, hexfmt.used, stdout);
+		hexfmt.used = 0;
+	}
+}
+
+/* render a single line (up to 16 bytes) into the output buffer */
+static void hexdump_line(const unsigned char *buf, uint64_t addr,
+			 size_t avail, unsigned int group)
+{
+	char *p = hexfmt.out + hexfmt.used;
+	size_t i, k;
+	int shift;
+
+	/* address, at least 8 hex digits */
+	for (shift = 60; shift >= 32 && !(addr >> shift); shift -= 4)
+		;
+	for (; shift >= 0; shift -= 4)
+		*p++ = "0123456789abcdef"[(addr >> shift) & 15];
+	*p++ = ':';
+	*p++ = ' ';
+
+	if (group == 1) {
 		for (i = 0; i < 16; i++) {
-			if (j + i < size)
-				printf("%02x ", buf[j+i]);
-			else
-				printf("__ ");
+			if (i < avail) {
+				memcpy(p, hexfmt.hex[buf[i]], 2);
+			} else {
+				p[0] = '_';
+				p[1] = '_';
+			}
+			p[2] = ' ';
+			p += 3;
 		}
-		putchar(' ');
-		for (i = 0; i < 16; i++) {
-			if (j + i >= size)
-				putchar('.');
-			else
-				putchar(isprint(buf[j+i]) ? buf[j+i] : '.');
+	} else {
+		for (i = 0; i < 16; i += group) {
+			for (k = group; k-- > 0; p += 2) {
+				if (i + k < avail) {
+					memcpy(p, hexfmt.hex[buf[i + k]], 2);
+				} else {
+					p[0] = '_';
+					p[1] = '_';
+				}
+			}
+			*p++ = ' ';
 		}
-		putchar('\n');
 	}
+	*p++ = ' ';
+	for (i = 0; i < 16; i++)
+		*p++ = i < avail ? hexfmt.ascii[buf[i]] : '.';
+	*p++ = '\n';
+
+	hexfmt.used = p - hexfmt.out;
+}
+
+/*
+ * Format a block of data. For streaming, this may be called repeatedly with
+ * consecutive chunks - as long as all but the last one are multiples of 16
+ * bytes, the output is identical to a single call.
+ */
+void hexdump_grouped(const void *data, uint64_t offset, size_t size,
+		     unsigned int group)
+{
+	const unsigned char *buf = data;
+	size_t j;
+
+	if (!hexfmt.initialized)
+		hexdump_init();
+	for (j = 0; j < size; j += 16) {
+		if (hexfmt.used > HEXDUMP_BUFSIZE - HEXDUMP_MAX_LINE)
+			hexdump_flush();
+		hexdump_line(buf + j, offset + j, size - j, group);
+	}
+	hexdump_flush();
+}
+
+void hexdump(void *data, uint32_t offset, size_t size)
+{
+	hexdump_grouped(data, offset, size, 1);
 }
 
 unsigned int file_size(const char *filename)
@@ -178,6 +289,7 @@ unsigned int file_size(const char *filename)
 
 int save_file(const char *name, void *data, size_t size)
 {
+	double start = fel_stats_time();
 	FILE *out = fopen(name, "wb");
 	int rc;
 	if (!out) {
@@ -186,11 +298,13 @@ int save_file(const char *name, void *data, size_t size)
 	}
 	rc = fwrite(data, size, 1, out);
 	fclose(out);
+	fel_stats_since(FEL_STAT_FILE_WRITE, size, start);
 	return rc;
 }
 
 void *load_file(const char *name, size_t *size)
 {
+	double start = fel_stats_time();
 	size_t offset = 0, bufsize = 8192;
 	char *buf = malloc(bufsize);
 	FILE *in;
@@ -220,16 +334,31 @@ void *load_file(const char *name, size_t *size)
 		*size = offset;
 	if (in != stdin)
 		fclose(in);
+	fel_stats_since(FEL_STAT_FILE_READ, offset, start);
 	return buf;
 }
 
-void aw_fel_hexdump(feldev_handle *dev, uint32_t offset, size_t size)
+/* read and display device memory in chunks, keeping memory usage low */
+void aw_fel_hexdump(feldev_handle *dev, uint32_t offset, size_t size,
+		    unsigned int group)
 {
-	if (size > 0) {
-		unsigned char buf[size];
-		aw_fel_read(dev, offset, buf, size);
-		hexdump(buf, offset, size);
+	size_t chunk_size = size < HEXDUMP_BUFSIZE ? size : HEXDUMP_BUFSIZE;
+	unsigned char *buf;
+	uint64_t addr = offset;
+
+	if (size == 0)
+		return;
+	buf = malloc(chunk_size);
+	if (!buf)
+		pr_fatal("hexdump: failed to allocate %zu bytes\n", chunk_size);
+	while (size > 0) {
+		size_t len = size < chunk_size ? size : chunk_size;
+		aw_fel_read(dev, addr, buf, len);
+		hexdump_grouped(buf, addr, len, group);
+		addr += len;
+		size -= len;
 	}
+	free(buf);
 }
 
 void aw_fel_dump(feldev_handle *dev, uint32_t offset, size_t size)
@@ -240,8 +369,50 @@ void aw_fel_dump(feldev_handle *dev, uint32_t offset, size_t size)
 		fwrite(buf, size, 1, stdout);
 	}
 }
+/*
+ * Dump a register block, using 32-bit word accesses only (unlike "hex" and
+ * "dump", which may use byte accesses). The data goes to a file in device
+ * (little-endian) byte order, or as a hexdump to stdout.
+ */
+void aw_fel_mmio_dump(feldev_handle *dev, uint32_t offset, size_t size,
+		      const char *filename)
+{
+	size_t i, count = (size + 3) / 4;
+	uint32_t *buf;
+
+	if (offset & 3)
+		pr_fatal("%s: address 0x%08X not 32-bit aligned\n",
+			 filename ? "mmio-save" : "mmio-dump", offset);
+	if (count == 0)
+		return;
+	buf = malloc(count * sizeof(uint32_t));
+	if (!buf)
+		pr_fatal("mmio-dump: failed to allocate %zu bytes\n", size);
+
+	fel_readl_bulk(dev, offset, buf, count);
+	for (i = 0; i < count; i++)
+		buf[i] = htole32(buf[i]);
+	if (filename)
+		save_file(filename, buf, count * sizeof(uint32_t));
+	else
+		hexdump_grouped(buf, offset, count * sizeof(uint32_t), 4);
+	free(buf);
+}
+
 void aw_fel_fill(feldev_handle *dev, uint32_t offset, size_t size, unsigned char value)
 {
+	/* let the DMA controller handle the word aligned bulk, if possible */
+	uint32_t head = (4 - (offset & 3)) & 3;
+	if (size > head) {
+		size_t bulk = (size - head) & ~(size_t)3;
+		if (aw_fel_dma_fill(dev, offset + head, value * 0x01010101U,
+				    bulk)) {
+			aw_fel_fill(dev, offset, head, value);
+			aw_fel_fill(dev, offset + head + bulk,
+				    size - head - bulk, value);
+			return;
+		}
+	}
 	if (size > 0) {
 		unsigned char buf[size];
 		memset(buf, value, size);
@@ -249,6 +420,47 @@ void aw_fel_fill(feldev_handle *dev, uint32_t offset, size_t size, unsigned char
 	}
 }
 
+/*
+ * Optional profiling of remote functions: the function gets called through
+ * a wrapper, which measures its execution time with the PMU cycle counter
+ * (PMCCNTR) and stores the cycle count next to the return value.
+ */
+static struct {
+	bool enabled;
+	bool prepared;		/* the uploaded function has the wrapper */
+	bool valid;		/* 'cycles' are from the last execution */
+	uint32_t cycles;
+} remotefunc_prof;
+
+/*
+ * Enable or disable the profiling wrapper for subsequently prepared remote
+ * functions. This needs an ARMv7 (or later) core, returns false otherwise.
+ */
+bool aw_fel_remotefunc_profiling(feldev_handle *dev, bool enable)
+{
+	uint32_t midr;
+
+	remotefunc_prof.enabled = false;
+	if (!enable || !dev->soc_info)
+		return !enable;
+	/* the PMU is only architected with the "CPUID" scheme (ARMv7) */
+	midr = aw_read_arm_cp_reg(dev, dev->soc_info, 15, 0, 0, 0, 0);
+	remotefunc_prof.enabled = ((midr >> 16) & 0xf) == 0xf;
+	return remotefunc_prof.enabled;
+}
+
+/*
+ * Retrieve the number of CPU cycles the last remote function execution
+ * took. Returns false if it wasn't profiled.
+ */
+bool aw_fel_remotefunc_cycles(feldev_handle *dev, uint32_t *cycles)
+{
+	(void)dev;
+	if (remotefunc_prof.valid)
+		*cycles = remotefunc_prof.cycles;
+	return remotefunc_prof.valid;
+}
+
 /*
  * Upload a function (implemented in native ARM code) to the device and
  * prepare for executing it. Use a subset of 32-bit ARM AAPCS calling
@@ -272,16 +484,19 @@ void aw_fel_fill(feldev_handle *dev, uint32_t offset, size_t size, unsigned char
  *       function arguments.
  */
 
-bool aw_fel_remotefunc_prepare(feldev_handle *dev,
-			       size_t                stack_size,
-			       void                 *arm_code,
-			       size_t                arm_code_size,
-			       size_t                num_args,
-			       uint32_t             *args)
+/*
+ * Build the memory image of a remote function, to be placed at 'base':
+ * entry code, saved lr/sp (the result goes to +0x48), the argument block
+ * (+0x50: new sp, number of arguments on the stack, stack arguments and
+ * r0-r3), an optional profiling wrapper, the function code and its stack.
+ * Returns a buffer of '*image_size' bytes, to be freed by the caller.
+ */
+static uint32_t *remotefunc_image(uint32_t base, size_t stack_size,
+				  const void *arm_code, size_t arm_code_size,
+				  size_t num_args, const uint32_t *args,
+				  bool profiled, size_t *image_size)
 {
 	size_t idx, i;
-	size_t tmp_buf_size;
-	soc_info_t *soc_info = dev->soc_info;
 	uint32_t *tmp_buf;
 	uint32_t new_sp, num_args_on_stack = (num_args <= 4 ? 0 : num_args - 4);
 	uint32_t entry_code[] = {
@@ -307,21 +522,49 @@ bool aw_fel_remotefunc_prepare(feldev_handle *dev,
 		htole32(0x00000000), /*   4c:    .word    0x00000000            */
 	};
 
-	if (!soc_info)
-		return false;
+	/*
+	 * Profiling wrapper, placed in front of the function. It returns to
+	 * BROM directly, with the result at +0x48 and the cycles at +0x4c.
+	 */
+	uint32_t prof_code[] = {
+		htole32(0xee19cf1c), /*    0:    mrc      15, 0, ip, cr9, cr12, {0} */
+		htole32(0xe38cc001), /*    4:    orr      ip, ip, #1            */
+		htole32(0xe3ccc008), /*    8:    bic      ip, ip, #8            */
+		htole32(0xee09cf1c), /*    c:    mcr      15, 0, ip, cr9, cr12, {0} */
+		htole32(0xe3a0c102), /*   10:    mov      ip, #0x80000000       */
+		htole32(0xee09cf3c), /*   14:    mcr      15, 0, ip, cr9, cr12, {1} */
+		htole32(0xee19cf1d), /*   18:    mrc      15, 0, ip, cr9, cr13, {0} */
+		htole32(0xe58fc024), /*   1c:    str      ip, [pc, #36]         */
+		htole32(0xeb00000a), /*   20:    bl       50 <func>             */
+		htole32(0xee191f1d), /*   24:    mrc      15, 0, r1, cr9, cr13, {0} */
+		htole32(0xe59f2018), /*   28:    ldr      r2, [pc, #24]         */
+		htole32(0xe0411002), /*   2c:    sub      r1, r1, r2            */
+		htole32(0xe59fc014), /*   30:    ldr      ip, [pc, #20]         */
+		htole32(0xe59ce048), /*   34:    ldr      lr, [ip, #72]         */
+		htole32(0xe59cd04c), /*   38:    ldr      sp, [ip, #76]         */
+		htole32(0xe58c0048), /*   3c:    str      r0, [ip, #72]         */
+		htole32(0xe58c104c), /*   40:    str      r1, [ip, #76]         */
+		htole32(0xe12fff1e), /*   44:    bx       lr                    */
+		htole32(0x00000000), /*   48:    .word    0x00000000 (start)    */
+		htole32(0x00000000), /*   4c:    .word    base address          */
+	};
+	size_t prof_size = profiled ? sizeof(prof_code) : 0;
 
 	/* Calculate the stack location */
-	new_sp = soc_info->scratch_addr +
+	new_sp = base +
 		 sizeof(entry_code) +
 		 2 * 4 +
 		 num_args_on_stack * 4 +
 		 4 * 4 +
+		 prof_size +
 		 arm_code_size +
 		 stack_size;
 	new_sp = (new_sp + 7) & ~7;
 
-	tmp_buf_size = new_sp - soc_info->scratch_addr;
-	tmp_buf = calloc(tmp_buf_size, 1);
+	*image_size = new_sp - base;
+	tmp_buf = calloc(*image_size, 1);
+	if (!tmp_buf)
+		pr_fatal("Failed to allocate remote function buffer\n");
 	memcpy(tmp_buf, entry_code, sizeof(entry_code));
 	idx = sizeof(entry_code) / 4;
 	tmp_buf[idx++] = htole32(new_sp);
@@ -330,10 +573,196 @@ bool aw_fel_remotefunc_prepare(feldev_handle *dev,
 		tmp_buf[idx++] = htole32(args[i]);
 	for (i = 0; i < 4; i++)
 		tmp_buf[idx++] = (i < num_args ? htole32(args[i]) : 0);
+	if (prof_size) {
+		prof_code[ARRAY_SIZE(prof_code) - 1] = htole32(base);
+		memcpy(tmp_buf + idx, prof_code, prof_size);
+		idx += prof_size / 4;
+	}
 	memcpy(tmp_buf + idx, arm_code, arm_code_size);
+	return tmp_buf;
+}
+
+/* offset of the argument block of a remote function, see remotefunc_image() */
+#define REMOTEFUNC_ARGS_OFFSET	0x50
 
+/*
+ * Registry of remote functions that stay resident on the device, in a code
+ * area of their own (see aw_fel_remotefunc_load()).
+ */
+#define REMOTEFUNC_MAX_LOADED	8
+
+static struct {
+	bool area_valid;	/* code area set up */
+	uint32_t start, end;	/* code area */
+	uint32_t next;		/* first free address in the code area */
+	unsigned int generation;/* invalidates the handles of earlier loads */
+	size_t count;
+	struct {
+		uint32_t base;
+		uint32_t sp;		/* initial stack pointer (end of image) */
+		void *arm_code;		/* copy, for comparison */
+		size_t arm_code_size;
+		size_t stack_size;
+		size_t num_args;
+		bool profiled;
+		bool args_valid;	/* 'args' are what the device has */
+		uint32_t *args;
+	} func[REMOTEFUNC_MAX_LOADED];
+} remotefunc_reg;
+
+/*
+ * Pick a default code area on the device: from the end of the 1 KiB scratch
+ * window (used by the readl_n/writel_n and other small thunks) up to the
+ * next area that is in use (BROM data buffers, the FEL-to-SPL thunk, the MMU
+ * translation table), or the end of the SRAM.
+ */
+static void remotefunc_default_area(feldev_handle *dev,
+				    uint32_t *start, uint32_t *end)
+{
+	soc_info_t *soc_info = dev->soc_info;
+	sram_swap_buffers *swap;
+
+	*start = soc_info->scratch_addr + 0x400;
+	*end = soc_info->spl_addr + soc_info->sram_size;
+	if (soc_info->thunk_addr >= *start && soc_info->thunk_addr < *end)
+		*end = soc_info->thunk_addr;
+	if (soc_info->mmu_tt_addr >= *start && soc_info->mmu_tt_addr < *end)
+		*end = soc_info->mmu_tt_addr;
+	if (dev->mmu_tt_addr >= *start && dev->mmu_tt_addr < *end)
+		*end = dev->mmu_tt_addr;
+	for (swap = soc_info->swap_buffers; swap && swap->size; swap++) {
+		if (swap->buf1 + swap->size <= *start || swap->buf1 >= *end)
+			continue;
+		if (swap->buf1 <= *start)
+			*start = swap->buf1 + swap->size;
+		else
+			*end = swap->buf1;
+	}
+	if (*end < *start)
+		*end = *start;
+}
+
+/*
+ * Forget about all loaded remote functions, e.g. because the code area got
+ * overwritten. Handles returned earlier become invalid.
+ */
+void aw_fel_remotefunc_unload_all(feldev_handle *dev)
+{
+	size_t i;
+
+	for (i = 0; i < remotefunc_reg.count; i++) {
+		free(remotefunc_reg.func[i].arm_code);
+		free(remotefunc_reg.func[i].args);
+	}
+	remotefunc_reg.count = 0;
+	remotefunc_reg.next = remotefunc_reg.start;
+	remotefunc_reg.generation++;
+	aw_fel_set_write_guard(dev, AW_FEL_GUARD_REMOTEFUNC, 0, 0, NULL);
+}
+
+/* any other write to the loaded functions makes them stale */
+static void remotefunc_write_guard(feldev_handle *dev)
+{
+	pr_info("Remote functions got overwritten, unloading them\n");
+	aw_fel_remotefunc_unload_all(dev);
+}
+
+static void remotefunc_guard(feldev_handle *dev)
+{
+	aw_fel_set_write_guard(dev, AW_FEL_GUARD_REMOTEFUNC,
+			       remotefunc_reg.start,
+			       remotefunc_reg.next - remotefunc_reg.start,
+			       remotefunc_write_guard);
+}
+
+/*
+ * Set the device memory area that holds the loaded remote functions, e.g.
+ * to move them to DRAM. A 'size' of 0 selects the default area in SRAM.
+ * This unloads all functions.
+ */
+void aw_fel_remotefunc_area(feldev_handle *dev, uint32_t addr, uint32_t size)
+{
+	uint32_t end = addr + size;
+
+	if (size == 0)
+		remotefunc_default_area(dev, &addr, &end);
+	remotefunc_reg.area_valid = true;
+	remotefunc_reg.start = (addr + 7) & ~7;
+	remotefunc_reg.end = end > remotefunc_reg.start ? end
+							: remotefunc_reg.start;
+	aw_fel_remotefunc_unload_all(dev);
+}
+
+/*
+ * Execute a remote function at 'base', and retrieve the return value (and
+ * the cycle count, if profiled) with a single read.
+ */
+static void remotefunc_run(feldev_handle *dev, uint32_t base, bool profiled,
+			   uint32_t *result)
+{
+	uint32_t data[2];
+	double start = fel_stats_time();
+
+	aw_fel_execute(dev, base);
+	remotefunc_prof.valid = profiled;
+	if (profiled) {
+		aw_fel_read(dev, base + 0x48, data, sizeof(data));
+		remotefunc_prof.cycles = le32toh(data[1]);
+		if (result)
+			*result = le32toh(data[0]);
+	} else if (result) {
+		aw_fel_read(dev, base + 0x48, result, sizeof(uint32_t));
+		*result = le32toh(*result);
+	}
+	fel_stats_since(FEL_STAT_REMOTEFUNC, 0, start);
+	if (profiled)
+		fel_stats_cycles(FEL_STAT_REMOTEFUNC, remotefunc_prof.cycles);
+}
+
+/*
+ * Upload a function (implemented in native ARM code) to the device and
+ * prepare for executing it. Use a subset of 32-bit ARM AAPCS calling
+ * conventions: all arguments are integer 32-bit values, and an optional
+ * return value is a 32-bit integer too. The function code needs to be
+ * compiled in the ARM mode (Thumb2 is not supported), it also must be
+ * a position independent leaf function (have no calls to anything else)
+ * and have no references to any global variables.
+ *
+ * 'stack_size'    - the required stack size for the function (can be
+ *                   calculated using the '-fstack-usage' GCC option)
+ * 'arm_code'      - a pointer to the memory buffer with the function code
+ * 'arm_code_size' - the size of the function code
+ * 'num_args'      - the number of 32-bit function arguments
+ * 'args'          - an array with the function argument values
+ *
+ * Note: once uploaded, the function can be executed multiple times with
+ *       exactly the same arguments. If some internal state needs to be
+ *       updated between function calls, then it's best to pass a pointer
+ *       to some state structure located elsewhere in SRAM as one of the
+ *       function arguments.
+ */
+
+bool aw_fel_remotefunc_prepare(feldev_handle *dev,
+			       size_t                stack_size,
+			       void                 *arm_code,
+			       size_t                arm_code_size,
+			       size_t                num_args,
+			       uint32_t             *args)
+{
+	soc_info_t *soc_info = dev->soc_info;
+	uint32_t *tmp_buf;
+	size_t tmp_buf_size;
+
+	if (!soc_info)
+		return false;
+
+	tmp_buf = remotefunc_image(soc_info->scratch_addr, stack_size,
+				   arm_code, arm_code_size, num_args, args,
+				   remotefunc_prof.enabled, &tmp_buf_size);
+	/* this unloads the resident functions, if it overlaps them */
 	aw_fel_write(dev, tmp_buf, soc_info->scratch_addr, tmp_buf_size);
 	free(tmp_buf);
+	remotefunc_prof.prepared = remotefunc_prof.enabled;
 	return true;
 }
 
@@ -344,13 +773,133 @@ bool aw_fel_remotefunc_prepare(feldev_handle *dev,
 bool aw_fel_remotefunc_execute(feldev_handle *dev, uint32_t *result)
 {
 	soc_info_t *soc_info = dev->soc_info;
+
 	if (!soc_info)
 		return false;
-	aw_fel_execute(dev, soc_info->scratch_addr);
-	if (result) {
-		aw_fel_read(dev, soc_info->scratch_addr + 0x48, result, sizeof(uint32_t));
-		*result = le32toh(*result);
+	remotefunc_run(dev, soc_info->scratch_addr, remotefunc_prof.prepared,
+		       result);
+	return true;
+}
+
+/*
+ * Load a remote function (with the same restrictions as for
+ * aw_fel_remotefunc_prepare()) into the code area, where it stays resident
+ * next to other functions loaded this way. Loading the same code again just
+ * returns the existing handle, so callers don't need to keep track of that.
+ * The 'arm_code' gets copied, so it may well live on the caller's stack.
+ *
+ * Returns a handle for aw_fel_remotefunc_call(), or -1 if there is no room
+ * left in the code area.
+ */
+int aw_fel_remotefunc_load(feldev_handle *dev,
+			   size_t                stack_size,
+			   const void           *arm_code,
+			   size_t                arm_code_size,
+			   size_t                num_args)
+{
+	uint32_t *tmp_buf, *args;
+	void *code;
+	size_t i, image_size, code_offset;
+
+	if (!dev->soc_info)
+		return -1;
+	if (!remotefunc_reg.area_valid)
+		aw_fel_remotefunc_area(dev, 0, 0);
+
+	for (i = 0; i < remotefunc_reg.count; i++) {
+		if (remotefunc_reg.func[i].arm_code_size == arm_code_size &&
+		    remotefunc_reg.func[i].stack_size == stack_size &&
+		    remotefunc_reg.func[i].num_args == num_args &&
+		    remotefunc_reg.func[i].profiled == remotefunc_prof.enabled &&
+		    memcmp(remotefunc_reg.func[i].arm_code, arm_code,
+			   arm_code_size) == 0)
+			return remotefunc_reg.generation * REMOTEFUNC_MAX_LOADED
+			       + i;
+	}
+	if (remotefunc_reg.count == REMOTEFUNC_MAX_LOADED)
+		return -1;
+
+	args = calloc(num_args ? num_args : 1, sizeof(uint32_t));
+	code = malloc(arm_code_size);
+	if (!args || !code)
+		pr_fatal("Failed to allocate remote function memory\n");
+	memcpy(code, arm_code, arm_code_size);
+	tmp_buf = remotefunc_image(remotefunc_reg.next, stack_size, arm_code,
+				   arm_code_size, num_args, args,
+				   remotefunc_prof.enabled, &image_size);
+	if (image_size > remotefunc_reg.end - remotefunc_reg.next) {
+		free(tmp_buf);
+		free(code);
+		free(args);
+		return -1;
 	}
+	/* the stack doesn't need to be uploaded */
+	code_offset = image_size - ((stack_size + 7) & ~7);
+	aw_fel_write(dev, tmp_buf, remotefunc_reg.next, code_offset);
+	free(tmp_buf);
+
+	i = remotefunc_reg.count++;
+	remotefunc_reg.func[i].base = remotefunc_reg.next;
+	remotefunc_reg.func[i].sp = remotefunc_reg.next + image_size;
+	remotefunc_reg.func[i].arm_code = code;
+	remotefunc_reg.func[i].arm_code_size = arm_code_size;
+	remotefunc_reg.func[i].stack_size = stack_size;
+	remotefunc_reg.func[i].num_args = num_args;
+	remotefunc_reg.func[i].profiled = remotefunc_prof.enabled;
+	remotefunc_reg.func[i].args_valid = true; /* zeros, see above */
+	remotefunc_reg.func[i].args = args;
+	remotefunc_reg.next += image_size;
+	remotefunc_guard(dev);
+	pr_info("Loaded remote function #%zu at 0x%08x (%zu bytes)\n",
+		i, remotefunc_reg.func[i].base, image_size);
+	return remotefunc_reg.generation * REMOTEFUNC_MAX_LOADED + i;
+}
+
+/*
+ * Call a loaded remote function with the given arguments ('num_args' as
+ * specified when loading it). This only uploads the argument block (if the
+ * arguments differ from the previous call), then executes the function and
+ * retrieves the return value if 'result' isn't NULL.
+ *
+ * Returns false if the handle isn't valid (any more).
+ */
+bool aw_fel_remotefunc_call(feldev_handle *dev, int handle,
+			    const uint32_t *args, uint32_t *result)
+{
+	size_t i, idx, num_args, num_args_on_stack;
+	uint32_t block[2 + 4 + 64];
+	int index = handle - remotefunc_reg.generation * REMOTEFUNC_MAX_LOADED;
+
+	if (handle < 0 || index < 0 || (size_t)index >= remotefunc_reg.count)
+		return false;
+
+	num_args = remotefunc_reg.func[index].num_args;
+	if (num_args > 64)
+		return false;
+	if (!remotefunc_reg.func[index].args_valid ||
+	    memcmp(remotefunc_reg.func[index].args, args,
+		   num_args * sizeof(uint32_t)) != 0) {
+		/* same layout as in remotefunc_image() */
+		num_args_on_stack = num_args <= 4 ? 0 : num_args - 4;
+		idx = 0;
+		block[idx++] = htole32(remotefunc_reg.func[index].sp);
+		block[idx++] = htole32(num_args_on_stack);
+		for (i = num_args - num_args_on_stack; i < num_args; i++)
+			block[idx++] = htole32(args[i]);
+		for (i = 0; i < 4; i++)
+			block[idx++] = (i < num_args ? htole32(args[i]) : 0);
+		/* our own update, don't trip the guard */
+		aw_fel_set_write_guard(dev, AW_FEL_GUARD_REMOTEFUNC, 0, 0, NULL);
+		aw_fel_write(dev, block, remotefunc_reg.func[index].base +
+			     REMOTEFUNC_ARGS_OFFSET,
+			     idx * sizeof(uint32_t));
+		remotefunc_guard(dev);
+		memcpy(remotefunc_reg.func[index].args, args,
+		       num_args * sizeof(uint32_t));
+		remotefunc_reg.func[index].args_valid = true;
+	}
+	remotefunc_run(dev, remotefunc_reg.func[index].base,
+		       remotefunc_reg.func[index].profiled, result);
 	return true;
 }
 
@@ -440,10 +989,17 @@ void aw_fel_print_sid(feldev_handle *dev, bool force_workaround)
 		printf("%08x%c", key[i], i < 3 ? ':' : '\n');
 }
 
+/*
+ * Dump all the SID sections. Rather than reading each section separately
+ * (which costs a thunk upload, an execute and a read request each time),
+ * fetch the whole area covered by the sections in a single pass.
+ */
 void aw_fel_dump_sid(feldev_handle *dev)
 {
 	uint32_t buffer[2048 / sizeof(uint32_t)]; /* total SID size is 2K */
 	soc_info_t *soc_info = dev->soc_info;
+	const sid_section *s;
+	uint32_t start = UINT32_MAX, end = 0;
 
 	if (!soc_info->sid_base || !soc_info->sid_sections) {
 		printf("SID memory maps for your SoC (%s) are unknown.\n",
@@ -451,19 +1007,27 @@ void aw_fel_dump_sid(feldev_handle *dev)
 		return;
 	}
 
-	for (const sid_section *s = soc_info->sid_sections; s->name; s++) {
-		uint32_t count = s->size_bits / 32;
+	for (s = soc_info->sid_sections; s->name; s++) {
+		if (s->offset < start)
+			start = s->offset;
+		if (s->offset + s->size_bits / 8 > end)
+			end = s->offset + s->size_bits / 8;
+	}
+	if (start >= end || end - start > sizeof(buffer) ||
+	    fel_read_sid(dev, buffer, start, end - start, false)) {
+		fprintf(stderr, "Read sid failed\n");
+		return;
+	}
 
-		if (fel_read_sid(dev, buffer, s->offset, count * 4, false)) {
-			fprintf(stderr, "Read sid:%s failed\n", s->name);
-			return;
-		}
+	for (s = soc_info->sid_sections; s->name; s++) {
+		uint32_t count = s->size_bits / 32;
+		uint32_t *val = buffer + (s->offset - start) / 4;
 
 		printf("%-15s", s->name);
 		for (uint32_t i = 0; i < count; i++) {
 			if (i > 0 && ((i % 8) == 0))
 				printf("\n%-15s", "");
-			printf(" %08x", buffer[i]);
+			printf(" %08x", val[i]);
 		}
 		putchar('\n');
 	}
@@ -598,48 +1162,92 @@ void aw_apply_smc_workaround(feldev_handle *dev)
 }
 
 /*
- * Reconstruct the same MMU translation table as used by the A20 BROM.
- * We are basically reverting the changes, introduced in newer SoC
- * variants. This works fine for the SoC variants with the memory
- * layout similar to A20 (the SRAM is in the first megabyte of the
- * address space and the BROM is in the last megabyte of the address
- * space).
+ * The MMU translation table gets handled on the device, by a thunk which
+ * can generate, validate and patch the table in place, and change the MMU
+ * state. Only the number of problems found comes back to the host.
  */
-uint32_t *aw_generate_mmu_translation_table(void)
+#define MMU_TT_GENERATE		0x01
+#define MMU_TT_VALIDATE		0x02
+#define MMU_TT_PATCH_DRAM	0x04
+#define MMU_TT_DISABLE		0x08
+#define MMU_TT_ENABLE		0x10
+#define MMU_TT_PATCH_BROM	0x20
+
+static uint32_t aw_mmu_tt_thunk(feldev_handle *dev, soc_info_t *soc_info,
+				uint32_t ttbr0, uint32_t mode)
 {
-	uint32_t *tt = malloc(4096 * sizeof(uint32_t));
-	uint32_t i;
+	uint32_t arm_code[] = {
+		#include "thunks/mmu-tt.h"
+		htole32(ttbr0),
+		htole32(mode),
+		0 /* result */
+	};
+	uint32_t result;
 
-	/*
-	 * Direct mapping using 1MB sections with TEXCB=00000 (Strongly
-	 * ordered) for all memory except the first and the last sections,
-	 * which have TEXCB=00100 (Normal). Domain bits are set to 1111
-	 * and AP bits are set to 11, but this is mostly irrelevant.
-	 */
-	for (i = 0; i < 4096; i++)
-		tt[i] = 0x00000DE2 | (i << 20);
-	tt[0x000] |= 0x1000;
-	tt[0xFFF] |= 0x1000;
+	aw_fel_write(dev, arm_code, soc_info->scratch_addr, sizeof(arm_code));
+	aw_fel_execute(dev, soc_info->scratch_addr);
+	aw_fel_read(dev, soc_info->scratch_addr + sizeof(arm_code) - 4,
+		    &result, sizeof(result));
+	return le32toh(result);
+}
 
-	return tt;
+/*
+ * Basically, ignore M/Z/I/V/UNK bits and expect no TEX remap.
+ * Bits [23:22] are Read-As-One on ARMv7, but Should-Be-Zero
+ * on ARMv5, so ignore them.
+ * We need the RES1 bits[18,16,4,3] and CP15BEN[5].
+ */
+static bool aw_sctlr_expected(uint32_t sctlr)
+{
+	return (sctlr & ~((0x3 << 22) | (0x7 << 11) | (1 << 6) | 1)) == 0x00050038;
 }
 
-uint32_t *aw_backup_and_disable_mmu(feldev_handle *dev,
-                                    soc_info_t *soc_info)
+/*
+ * Host writes over an active translation table would crash the device, so
+ * the MMU gets disabled right before. The SPL flow enables it again later.
+ */
+static void aw_mmu_write_guard(feldev_handle *dev)
+{
+	pr_info("Disabling the MMU, its translation table gets overwritten\n");
+	aw_mmu_tt_thunk(dev, dev->soc_info, 0, MMU_TT_DISABLE);
+}
+
+static bool ranges_overlap(uint32_t a, uint32_t a_size,
+			   uint32_t b, uint32_t b_size)
+{
+	return a < b + b_size && b < a + a_size;
+}
+
+/* can running an SPL of 'spl_len' bytes overwrite the table at 'ttbr0'? */
+static bool aw_spl_overwrites_tt(soc_info_t *soc_info, uint32_t spl_len,
+				 uint32_t ttbr0)
+{
+	sram_swap_buffers *swap;
+
+	if (ranges_overlap(ttbr0, 0x4000, soc_info->spl_addr, spl_len) ||
+	    ranges_overlap(ttbr0, 0x4000, soc_info->thunk_addr,
+			   soc_info->thunk_size))
+		return true;
+	for (swap = soc_info->swap_buffers; swap && swap->size; swap++)
+		if (ranges_overlap(ttbr0, 0x4000, swap->buf1, swap->size) ||
+		    ranges_overlap(ttbr0, 0x4000, swap->buf2, swap->size))
+			return true;
+	return false;
+}
+
+/*
+ * Check the BROM's MMU setup, and disable the MMU if it was enabled. The
+ * translation table is validated on the device to be a direct mapping.
+ * It stays in place. Only if an SPL of 'spl_len' bytes could overwrite it,
+ * a copy is kept on the host, returned in 'tt' (in device byte order).
+ * Returns true if the MMU needs to be restored later.
+ */
+bool aw_backup_and_disable_mmu(feldev_handle *dev, soc_info_t *soc_info,
+			       uint32_t spl_len, uint32_t **tt)
 {
-	uint32_t *tt = NULL;
 	uint32_t sctlr, ttbr0, ttbcr, dacr;
-	uint32_t i;
 
-	uint32_t arm_code[] = {
-		/* Disable I-cache, MMU and branch prediction */
-		htole32(0xee110f10), /* mrc        15, 0, r0, cr1, cr0, {0}  */
-		htole32(0xe3c00001), /* bic        r0, r0, #1                */
-		htole32(0xe3c00b06), /* bic        r0, r0, #0x1800           */
-		htole32(0xee010f10), /* mcr        15, 0, r0, cr1, cr0, {0}  */
-		/* Return back to FEL */
-		htole32(0xe12fff1e), /* bx         lr                        */
-	};
+	*tt = NULL;
 
 	/*
 	 * Below are some checks for the register values, which are known
@@ -652,19 +1260,16 @@ uint32_t *aw_backup_and_disable_mmu(feldev_handle *dev,
 	 * checks needs to be relaxed).
 	 */
 
-	/*
-	 * Basically, ignore M/Z/I/V/UNK bits and expect no TEX remap.
-	 * Bits [23:22] are Read-As-One on ARMv7, but Should-Be-Zero
-	 * on ARMv5, so ignore them.
-	 * We need the RES1 bits[18,16,4,3] and CP15BEN[5].
-	 */
 	sctlr = aw_get_sctlr(dev, soc_info);
-	if ((sctlr & ~((0x3 << 22) | (0x7 << 11) | (1 << 6) | 1)) != 0x00050038)
+	if (!aw_sctlr_expected(sctlr))
 		pr_fatal("Unexpected SCTLR (%08X)\n", sctlr);
 
+	/* the MMU gets disabled here, no need to guard the table any more */
+	aw_fel_set_write_guard(dev, AW_FEL_GUARD_MMU, 0, 0, NULL);
+
 	if (!(sctlr & 1)) {
 		pr_info("MMU is not enabled by BROM\n");
-		return NULL;
+		return false;
 	}
 
 	dacr = aw_get_dacr(dev, soc_info);
@@ -679,84 +1284,211 @@ uint32_t *aw_backup_and_disable_mmu(feldev_handle *dev,
 	if (ttbr0 & 0x3FFF)
 		pr_fatal("Unexpected TTBR0 (%08X)\n", ttbr0);
 
-	tt = malloc(16 * 1024);
-	pr_info("Reading the MMU translation table from 0x%08X\n", ttbr0);
-	aw_fel_read(dev, ttbr0, tt, 16 * 1024);
-	for (i = 0; i < 4096; i++)
-		tt[i] = le32toh(tt[i]);
+	/* Sanity checks (valid direct mapping), then disable the MMU */
+	pr_info("Checking the MMU translation table at 0x%08X, disabling "
+		"I-cache, MMU and branch prediction...", ttbr0);
+	if (aw_mmu_tt_thunk(dev, soc_info, ttbr0,
+			    MMU_TT_VALIDATE | MMU_TT_DISABLE) != 0)
+		pr_fatal("MMU: not a direct mapping of section descriptors\n");
+	pr_info(" done.\n");
 
-	/* Basic sanity checks to be sure that this is a valid table */
-	for (i = 0; i < 4096; i++) {
-		if (((tt[i] >> 1) & 1) != 1 || ((tt[i] >> 18) & 1) != 0)
-			pr_fatal("MMU: not a section descriptor\n");
-		if ((tt[i] >> 20) != i)
-			pr_fatal("MMU: not a direct mapping\n");
+	if (aw_spl_overwrites_tt(soc_info, spl_len, ttbr0)) {
+		pr_info("MMU: the SPL may overwrite the table, keeping a copy\n");
+		*tt = malloc(16 * 1024);
+		if (!*tt)
+			pr_fatal("MMU: failed to allocate the translation table backup\n");
+		aw_fel_read(dev, ttbr0, *tt, 16 * 1024);
 	}
+	return true;
+}
 
-	pr_info("Disabling I-cache, MMU and branch prediction...");
-	aw_fel_write(dev, arm_code, soc_info->scratch_addr, sizeof(arm_code));
-	aw_fel_execute(dev, soc_info->scratch_addr);
+/*
+ * Set up the translation table at TTBR0 for performance (write-combine
+ * mapping for DRAM, cached mapping for BROM) and enable the MMU.
+ * If the table got overwritten (e.g. by the SPL), the host copy 'tt' from
+ * aw_backup_and_disable_mmu() gets written back first; it is freed here.
+ * With 'generate', a new table gets generated: the same one as used by the
+ * A20 BROM, which works fine for the SoC variants with the memory layout
+ * similar to A20 (the SRAM is in the first megabyte of the address space
+ * and the BROM is in the last megabyte of the address space).
+ */
+void aw_restore_and_enable_mmu(feldev_handle *dev, soc_info_t *soc_info,
+			       bool generate, uint32_t *tt)
+{
+	uint32_t ttbr0 = aw_get_ttbr0(dev, soc_info);
+	uint32_t mode = MMU_TT_VALIDATE | MMU_TT_PATCH_DRAM |
+			MMU_TT_PATCH_BROM | MMU_TT_ENABLE;
+
+	pr_info("%s the MMU translation table at 0x%08X, enabling I-cache, "
+		"MMU and branch prediction...",
+		generate ? "Generating" : "Patching", ttbr0);
+	if (generate)
+		mode |= MMU_TT_GENERATE;
+	if (aw_mmu_tt_thunk(dev, soc_info, ttbr0, mode) != 0) {
+		if (generate)
+			pr_fatal("MMU: failed to generate the translation table\n");
+		if (!tt)
+			pr_fatal("MMU: the translation table got overwritten\n");
+		pr_info(" overwritten, restoring the backup...");
+		aw_fel_write(dev, tt, ttbr0, 16 * 1024);
+		if (aw_mmu_tt_thunk(dev, soc_info, ttbr0, mode) != 0)
+			pr_fatal("MMU: the restored translation table is invalid\n");
+	}
 	pr_info(" done.\n");
+	free(tt);
+	aw_fel_set_write_guard(dev, AW_FEL_GUARD_MMU, ttbr0, 0x4000,
+			       aw_mmu_write_guard);
+}
 
-	return tt;
+/*
+ * Find a 16K aligned block in the SRAM at 'spl_addr' for an MMU translation
+ * table, clear of the areas sunxi-fel and the BROM use: the staging buffer
+ * and scratch window, the SPL thunk, and the BROM stacks / data along with
+ * their backup locations. The highest such block gets picked, to stay out
+ * of the way of data uploaded to the start of the SRAM. Returns 0 if there
+ * is none.
+ */
+static uint32_t aw_find_mmu_tt_block(soc_info_t *soc_info)
+{
+	sram_swap_buffers *swap;
+	uint32_t addr = (soc_info->spl_addr + soc_info->sram_size) & ~0x3FFF;
+
+	for (; addr >= soc_info->spl_addr + 0x4000; addr -= 0x4000) {
+		uint32_t tt = addr - 0x4000;
+		bool used;
+
+		used = ranges_overlap(tt, 0x4000, soc_info->spl_addr,
+				      soc_info->scratch_addr + 0x400 -
+				      soc_info->spl_addr) ||
+		       ranges_overlap(tt, 0x4000, soc_info->thunk_addr,
+				      soc_info->thunk_size);
+		for (swap = soc_info->swap_buffers; swap && swap->size; swap++)
+			used = used ||
+			       ranges_overlap(tt, 0x4000, swap->buf1, swap->size) ||
+			       ranges_overlap(tt, 0x4000, swap->buf2, swap->size);
+		if (!used)
+			return tt;
+	}
+	return 0;
 }
 
-void aw_restore_and_enable_mmu(feldev_handle *dev,
-                               soc_info_t *soc_info,
-                               uint32_t *tt)
+/*
+ * With --mmu, enable the MMU and I-cache for the FEL session, not just after
+ * running an SPL: the BROM code moves the USB data with the CPU, which is a
+ * lot faster when running from cache. This is opt-in, as the MMU stays on
+ * after sunxi-fel exits, which code started with "exe" might not expect.
+ * If the BROM has the MMU enabled already, just its own mapping gets
+ * patched to be cached. Otherwise a table gets generated, at 'mmu_tt_addr'
+ * or in a free SRAM block, with the SRAM as normal (write-combine) memory.
+ * The DRAM stays strongly ordered, as it may not be initialized yet and
+ * must not see any speculative accesses. The SPL flow makes it
+ * write-combine later on, see above. The table address is kept in the
+ * device handle, the SoC table stays untouched.
+ *
+ * This only works with the BROM in the last megabyte (high vectors), and
+ * on ARMv7 cores. Other SoCs just keep running uncached.
+ */
+void aw_mmu_auto_setup(feldev_handle *dev)
 {
-	uint32_t i;
-	uint32_t ttbr0 = aw_get_ttbr0(dev, soc_info);
+	soc_info_t *soc_info = dev->soc_info;
+	uint32_t midr, sctlr, ttbr0;
+	uint32_t mode = MMU_TT_VALIDATE | MMU_TT_PATCH_BROM | MMU_TT_ENABLE;
 
-	uint32_t arm_code[] = {
-		/* Invalidate I-cache, TLB and BTB */
-		htole32(0xe3a00000), /* mov        r0, #0                    */
-		htole32(0xee080f17), /* mcr        15, 0, r0, cr8, cr7, {0}  */
-		htole32(0xee070f15), /* mcr        15, 0, r0, cr7, cr5, {0}  */
-		htole32(0xee070fd5), /* mcr        15, 0, r0, cr7, cr5, {6}  */
-		htole32(0xf57ff04f), /* dsb        sy                        */
-		htole32(0xf57ff06f), /* isb        sy                        */
-		/* Enable I-cache, MMU and branch prediction */
-		htole32(0xee110f10), /* mrc        15, 0, r0, cr1, cr0, {0}  */
-		htole32(0xe3800001), /* orr        r0, r0, #1                */
-		htole32(0xe3800b06), /* orr        r0, r0, #0x1800           */
-		htole32(0xee010f10), /* mcr        15, 0, r0, cr1, cr0, {0}  */
-		/* Return back to FEL */
-		htole32(0xe12fff1e), /* bx         lr                        */
-	};
+	/* unknown SoC (no layout info), or instruction cache trouble */
+	if (soc_info->soc_id == 0 || soc_info->icache_fix)
+		return;
 
-	pr_info("Setting write-combine mapping for DRAM.\n");
-	for (i = (DRAM_BASE >> 20); i < ((DRAM_BASE + DRAM_SIZE) >> 20); i++) {
-		/* Clear TEXCB bits */
-		tt[i] &= ~((7 << 12) | (1 << 3) | (1 << 2));
-		/* Set TEXCB to 00100 (Normal uncached mapping) */
-		tt[i] |= (1 << 12);
+	midr = aw_read_arm_cp_reg(dev, soc_info, 15, 0, 0, 0, 0);
+	sctlr = aw_get_sctlr(dev, soc_info);
+	if (((midr >> 16) & 0xF) != 0xF || !(sctlr & (1 << 13)) ||
+	    !aw_sctlr_expected(sctlr)) {
+		pr_info("MMU: not supported on this SoC (SCTLR %08X)\n", sctlr);
+		return;
 	}
 
-	pr_info("Setting cached mapping for BROM.\n");
-	/* Clear TEXCB bits first */
-	tt[0xFFF] &= ~((7 << 12) | (1 << 3) | (1 << 2));
-	/* Set TEXCB to 00111 (Normal write-back cached mapping) */
-	tt[0xFFF] |= (1 << 12) | /* TEX */
-		     (1 << 3)  | /* C */
-		     (1 << 2);   /* B */
-
-	pr_info("Writing back the MMU translation table.\n");
-	for (i = 0; i < 4096; i++)
-		tt[i] = htole32(tt[i]);
-	aw_fel_write(dev, tt, ttbr0, 16 * 1024);
+	if (sctlr & 1) {
+		ttbr0 = aw_get_ttbr0(dev, soc_info);
+		if ((ttbr0 & 0x3FFF) || aw_get_ttbcr(dev, soc_info) != 0 ||
+		    aw_get_dacr(dev, soc_info) != 0x55555555) {
+			pr_info("MMU: unexpected setup, leaving it alone\n");
+			return;
+		}
+	} else {
+		ttbr0 = soc_info->mmu_tt_addr;
+		if (!ttbr0)
+			ttbr0 = aw_find_mmu_tt_block(soc_info);
+		if (!ttbr0 || (ttbr0 & 0x3FFF)) {
+			pr_info("MMU: no room for a translation table in SRAM\n");
+			return;
+		}
+		/* same settings as in the SPL flow, see there */
+		aw_set_dacr(dev, soc_info, 0x55555555);
+		aw_set_ttbcr(dev, soc_info, 0x00000000);
+		aw_set_ttbr0(dev, soc_info, ttbr0);
+		mode |= MMU_TT_GENERATE;
+	}
 
-	pr_info("Enabling I-cache, MMU and branch prediction...");
-	aw_fel_write(dev, arm_code, soc_info->scratch_addr, sizeof(arm_code));
-	aw_fel_execute(dev, soc_info->scratch_addr);
+	pr_info("%s the MMU translation table at 0x%08X, enabling I-cache, "
+		"MMU and branch prediction...",
+		sctlr & 1 ? "Patching" : "Generating", ttbr0);
+	if (aw_mmu_tt_thunk(dev, soc_info, ttbr0, mode) != 0) {
+		pr_info(" not a direct mapping, skipped.\n");
+		return;
+	}
 	pr_info(" done.\n");
-
-	free(tt);
+	/* keep it clear of remote functions and the benchmark */
+	dev->mmu_tt_addr = ttbr0;
+	aw_fel_set_write_guard(dev, AW_FEL_GUARD_MMU, ttbr0, 0x4000,
+			       aw_mmu_write_guard);
 }
 
 /* Minimum offset of the main U-Boot image within u-boot-sunxi-with-spl.bin. */
 #define SPL_MIN_OFFSET 0x8000
 
+/*
+ * Polling for the SPL result: after returning to FEL, the SPL header has its
+ * "eGON.BT0" signature replaced with "eGON.FEL". This is normally there right
+ * away, but (for reasons not understood yet) some setups need some extra time
+ * to settle. Instead of always waiting a fixed time, check for the signature
+ * with exponentially increasing delays, giving up after SPL_POLL_TIMEOUT.
+ * The A10, A13, A20 and A31 (the SoCs supported when the original fixed
+ * 250 ms delay was introduced) keep it as 'spl_settle_us', since it is not
+ * known whether reading back too early upsets their BROM's USB handling.
+ */
+#define SPL_POLL_MIN_US		500
+#define SPL_POLL_MAX_US		32000
+#define SPL_POLL_TIMEOUT	1.0	/* seconds */
+
+static void aw_fel_wait_for_spl(feldev_handle *dev, char *signature)
+{
+	soc_info_t *soc_info = dev->soc_info;
+	uint32_t delay = soc_info->spl_settle_us;
+	double start = gettime(), sleep_start;
+	unsigned int polls = 0;
+	struct timespec req;
+
+	for (;;) {
+		if (delay) {
+			req.tv_sec = delay / 1000000;
+			req.tv_nsec = (delay % 1000000) * 1000;
+			sleep_start = fel_stats_time();
+			nanosleep(&req, NULL);
+			fel_stats_since(FEL_STAT_SLEEP, 0, sleep_start);
+		}
+		aw_fel_read(dev, soc_info->spl_addr + 4, signature, 8);
+		polls++;
+		/* anything but the unchanged header is a final result */
+		if (memcmp(signature, "eGON.BT0", 8) != 0 ||
+		    gettime() - start > SPL_POLL_TIMEOUT)
+			break;
+		delay = delay < SPL_POLL_MIN_US ? SPL_POLL_MIN_US : delay * 2;
+		if (delay > SPL_POLL_MAX_US)
+			delay = SPL_POLL_MAX_US;
+	}
+	pr_info("SPL: result after %.1f ms (%u poll%s)\n",
+		(gettime() - start) * 1000., polls, polls > 1 ? "s" : "");
+}
+
 uint32_t aw_fel_write_and_execute_spl(feldev_handle *dev, uint8_t *buf, size_t len)
 {
 	soc_info_t *soc_info = dev->soc_info;
@@ -765,42 +1497,48 @@ uint32_t aw_fel_write_and_execute_spl(feldev_handle *dev, uint8_t *buf, size_t l
 	size_t i, thunk_size;
 	uint32_t *thunk_buf;
 	uint32_t sp, sp_irq;
-	uint32_t spl_checksum, spl_len, spl_len_limit;
-	uint32_t *buf32 = (uint32_t *)buf;
+	uint32_t spl_len, spl_len_limit;
 	uint32_t cur_addr = soc_info->spl_addr;
-	uint32_t *tt = NULL;
+	uint32_t *tt;
+	bool restore_tt, generate_tt;
 
 	if (!soc_info || !soc_info->swap_buffers)
 		pr_fatal("SPL: Unsupported SoC type\n");
-	if (len < 32 || memcmp(buf + 4, "eGON.BT0", 8) != 0)
+	if (len < 32 || memcmp(buf + 4, EGON_MAGIC_BT0, 8) != 0)
 		pr_fatal("SPL: eGON header is not found\n");
 
-	spl_checksum = 2 * le32toh(buf32[3]) - 0x5F0A6C39;
-	spl_len = le32toh(buf32[4]);
-
-	if (spl_len > len || (spl_len % 4) != 0)
+	switch (egon_verify(buf, len, NULL)) {
+	case EGON_OK:
+		break;
+	case EGON_BAD_CHECKSUM:
+		pr_fatal("SPL: checksum check failed\n");
+	default:
 		pr_fatal("SPL: bad length in the eGON header\n");
+	}
+	len = spl_len = egon_length(buf);
 
-	len = spl_len;
-	for (i = 0; i < len / 4; i++)
-		spl_checksum -= le32toh(buf32[i]);
-
-	if (spl_checksum != 0)
-		pr_fatal("SPL: checksum check failed\n");
+	/* the SPL overwrites the SRAM, including the remote functions */
+	aw_fel_remotefunc_unload_all(dev);
 
 	if (soc_info->needs_l2en) {
 		pr_info("Enabling the L2 cache\n");
+		fel_stats_phase_begin("spl:l2-cache");
 		aw_enable_l2_cache(dev, soc_info);
+		fel_stats_phase_end();
 	}
 
+	fel_stats_phase_begin("spl:stack-info");
 	aw_get_stackinfo(dev, soc_info, &sp_irq, &sp);
+	fel_stats_phase_end();
 	pr_info("Stack pointers: sp_irq=0x%08X, sp=0x%08X\n", sp_irq, sp);
 
-	tt = aw_backup_and_disable_mmu(dev, soc_info);
-	if (!tt && soc_info->mmu_tt_addr) {
+	fel_stats_phase_begin("spl:mmu-backup");
+	restore_tt = aw_backup_and_disable_mmu(dev, soc_info, spl_len, &tt);
+	generate_tt = !restore_tt && soc_info->mmu_tt_addr;
+	if (generate_tt) {
 		if (soc_info->mmu_tt_addr & 0x3FFF)
 			pr_fatal("SPL: 'mmu_tt_addr' must be 16K aligned\n");
-		pr_info("Generating the new MMU translation table at 0x%08X\n",
+		pr_info("Setting up a new MMU translation table at 0x%08X\n",
 			soc_info->mmu_tt_addr);
 		/*
 		 * These settings are used by the BROM in A10/A13/A20 and
@@ -815,9 +1553,10 @@ uint32_t aw_fel_write_and_execute_spl(feldev_handle *dev, uint8_t *buf, size_t l
 		aw_set_dacr(dev, soc_info, 0x55555555);
 		aw_set_ttbcr(dev, soc_info, 0x00000000);
 		aw_set_ttbr0(dev, soc_info, soc_info->mmu_tt_addr);
-		tt = aw_generate_mmu_translation_table();
 	}
+	fel_stats_phase_end();
 
+	fel_stats_phase_begin("spl:upload");
 	spl_len_limit = soc_info->sram_size;
 
 	swap_buffers = soc_info->swap_buffers;
@@ -856,6 +1595,7 @@ uint32_t aw_fel_write_and_execute_spl(feldev_handle *dev, uint8_t *buf, size_t l
 	/* Write the remaining part of the SPL */
 	if (len > 0)
 		aw_fel_write(dev, buf, cur_addr, len);
+	fel_stats_phase_end();
 
 	thunk_size = sizeof(fel_to_spl_thunk) + sizeof(soc_info->spl_addr) +
 		     (i + 1) * sizeof(*swap_buffers);
@@ -875,28 +1615,46 @@ uint32_t aw_fel_write_and_execute_spl(feldev_handle *dev, uint8_t *buf, size_t l
 		thunk_buf[i] = htole32(thunk_buf[i]);
 
 	pr_info("=> Executing the SPL...");
+	fel_stats_phase_begin("spl:execute");
 	aw_fel_write(dev, thunk_buf, soc_info->thunk_addr, thunk_size);
 	aw_fel_execute(dev, soc_info->thunk_addr);
+	fel_stats_phase_end();
 	pr_info(" done.\n");
 
 	free(thunk_buf);
 
-	/* TODO: Try to find and fix the bug, which needs this workaround */
-	struct timespec req = { .tv_nsec = 250000000 }; /* 250ms */
-	nanosleep(&req, NULL);
-
 	/* Read back the result and check if everything was fine */
-	aw_fel_read(dev, soc_info->spl_addr + 4, header_signature, 8);
+	fel_stats_phase_begin("spl:wait");
+	aw_fel_wait_for_spl(dev, header_signature);
+	fel_stats_phase_end();
 	if (strcmp(header_signature, "eGON.FEL") != 0)
 		pr_fatal("SPL: failure code '%s'\n", header_signature);
 
 	/* re-enable the MMU if it was enabled by BROM */
-	if (tt != NULL)
-		aw_restore_and_enable_mmu(dev, soc_info, tt);
+	if (restore_tt || generate_tt) {
+		fel_stats_phase_begin("spl:mmu-restore");
+		aw_restore_and_enable_mmu(dev, soc_info, generate_tt, tt);
+		fel_stats_phase_end();
+	}
 
 	return spl_len;
 }
 
+/* CRC32 calculation that runs in parallel to a USB transfer */
+typedef struct {
+	const uint8_t *data;
+	size_t size;
+	uint32_t crc;
+} crc_job_t;
+
+static void *crc_thread(void *arg)
+{
+	crc_job_t *job = arg;
+
+	job->crc = crc32_update(0, job->data, job->size);
+	return NULL;
+}
+
 /*
  * This function tests a given buffer address and length for a valid U-Boot
  * image. Upon success, the image data gets transferred to the default memory
@@ -904,7 +1662,8 @@ uint32_t aw_fel_write_and_execute_spl(feldev_handle *dev, uint8_t *buf, size_t l
  * U-Boot entry point (offset) and size values.
  */
 static void aw_fel_write_uboot_image(feldev_handle *dev, uint8_t *buf,
-				     size_t len, const char *dt_name)
+				     size_t len, const char *dt_name,
+				     progress_cb_t callback)
 {
 	if (len <= HEADER_SIZE)
 		return; /* Insufficient size (no actual data), just bail out */
@@ -929,8 +1688,8 @@ static void aw_fel_write_uboot_image(feldev_handle *dev, uint8_t *buf,
 	}
 	if (image_type == IH_TYPE_FLATDT) {		/* FIT image */
 		uboot_entry = load_fit_images(dev, buf, dt_name,
-					      &enter_in_aarch64);
-		uboot_size = 4;		/* dummy value to pass check below */
+					      &enter_in_aarch64, callback);
+		uboot_range_count = fit_loaded_ranges(&uboot_ranges);
 		return;
 	}
 
@@ -941,7 +1700,7 @@ static void aw_fel_write_uboot_image(feldev_handle *dev, uint8_t *buf,
 	/* The CRC is calculated on the whole header but the CRC itself */
 	uint32_t hcrc = be32toh(hdr.ih_hcrc);
 	hdr.ih_hcrc = 0;
-	uint32_t computed_hcrc = crc32(0, (const uint8_t *) &hdr, HEADER_SIZE);
+	uint32_t computed_hcrc = crc32_update(0, &hdr, HEADER_SIZE);
 	if (hcrc != computed_hcrc)
 		pr_fatal("U-Boot header CRC mismatch: expected %x, got %x\n",
 			 hcrc, computed_hcrc);
@@ -953,21 +1712,35 @@ static void aw_fel_write_uboot_image(feldev_handle *dev, uint8_t *buf,
 			 "expected %zu bytes, got %u\n",
 			 len - HEADER_SIZE, data_size);
 
-	uint32_t dcrc = be32toh(hdr.ih_dcrc);
-	uint32_t computed_dcrc = crc32(0, buf + HEADER_SIZE, data_size);
-	if (dcrc != computed_dcrc)
-		pr_fatal("U-Boot data CRC mismatch: expected %x, got %x\n",
-			 dcrc, computed_dcrc);
+	/*
+	 * The data CRC gets computed by a worker thread, while the image is
+	 * already on its way to the device. A mismatch is still fatal, and
+	 * we bail out before recording the U-Boot entry point - so a corrupt
+	 * image might end up in memory, but will never get executed.
+	 */
+	crc_job_t job = {
+		.data = buf + HEADER_SIZE,
+		.size = data_size,
+	};
+	pipeline_thread_t *thread = pipeline_thread_start(crc_thread, &job);
 
-	/* If we get here, we're "good to go" (i.e. actually write the data) */
 	pr_info("Writing image \"%.*s\", %u bytes @ 0x%08X.\n",
 		IH_NMLEN, buf + HEADER_NAME_OFFSET, data_size, load_addr);
 
 	aw_write_buffer(dev, buf + HEADER_SIZE, load_addr, data_size, false);
 
+	pipeline_thread_join(thread);
+	uint32_t dcrc = be32toh(hdr.ih_dcrc);
+	if (dcrc != job.crc)
+		pr_fatal("U-Boot data CRC mismatch: expected %x, got %x\n",
+			 dcrc, job.crc);
+
 	/* keep track of U-Boot memory region in global vars */
 	uboot_entry = load_addr;
-	uboot_size = data_size;
+	uboot_legacy_range.addr = load_addr;
+	uboot_legacy_range.size = data_size;
+	uboot_ranges = &uboot_legacy_range;
+	uboot_range_count = 1;
 }
 
 static const char *spl_get_dtb_name(uint8_t *spl_buf)
@@ -995,12 +1768,15 @@ static const char *spl_get_dtb_name(uint8_t *spl_buf)
 /*
  * This function handles the common part of both "spl" and "uboot" commands.
  */
-void aw_fel_process_spl_and_uboot(feldev_handle *dev, const char *filename)
+void aw_fel_process_spl_and_uboot(feldev_handle *dev, const char *filename,
+				  progress_cb_t callback)
 {
 	size_t size;
 	uint32_t offset;
 	/* load file into memory buffer */
+	fel_stats_phase_begin("load-file");
 	uint8_t *buf = load_file(filename, &size);
+	fel_stats_phase_end();
 	const char *dt_name = spl_get_dtb_name(buf);
 
 	/* write and execute the SPL from the buffer */
@@ -1011,8 +1787,10 @@ void aw_fel_process_spl_and_uboot(feldev_handle *dev, const char *filename)
 		/* U-Boot pads to at least 32KB */
 		if (offset < SPL_MIN_OFFSET)
 			offset = SPL_MIN_OFFSET;
+		fel_stats_phase_begin("uboot:upload");
 		aw_fel_write_uboot_image(dev, buf + offset, size - offset,
-					 dt_name);
+					 dt_name, callback);
+		fel_stats_phase_end();
 	}
 	free(buf);
 }
@@ -1163,6 +1941,127 @@ static bool is_uEnv(void *buffer, size_t size)
 	return memcmp(buffer, "#=uEnv", 6) == 0;
 }
 
+/*
+ * Pseudo image type for uEnv-style data, as detected by the validation stage
+ * of the file upload pipeline (get_image_type() reports IH_TYPE_INVALID here).
+ */
+#define IH_TYPE_UENV		-2
+
+/* state shared between file_upload() and its reader thread */
+typedef struct {
+	size_t count;		/* number of files */
+	char **argv;		/* "addr file" argument pairs */
+	bqueue_t *queue;	/* connection to the USB sender stage */
+	const char *error;	/* set on failure, with 'error_file' and errno */
+	const char *error_file;
+	int error_errno;
+} file_reader_t;
+
+/*
+ * Record a failure and stop reading. The main thread reports it, after the
+ * data queued so far (and the USB transfer in flight) has been completed.
+ */
+static void *file_reader_fail(file_reader_t *reader, const char *error,
+			      const char *name, FILE *in)
+{
+	reader->error = error;
+	reader->error_file = name;
+	reader->error_errno = errno;
+	if (in)
+		fclose(in);
+	bqueue_close(reader->queue);
+	return NULL;
+}
+
+/*
+ * Reader and validation stage of the file upload pipeline. All files get read
+ * in chunks, the first chunk of each file is used to determine its type, and
+ * everything is passed on to the USB sender via a bounded queue. This way
+ * disk I/O and header checks for the next chunk (or file) overlap with the
+ * USB transfer of the current one.
+ */
+static void *file_reader_thread(void *arg)
+{
+	file_reader_t *reader = arg;
+	upload_chunk_t *chunk;
+	unsigned int i;
+
+	for (i = 0; i < reader->count; i++) {
+		const char *name = reader->argv[i * 2 + 1];
+		uint32_t offset = strtoul(reader->argv[i * 2], NULL, 0);
+		int image_type = IH_TYPE_INVALID;
+		size_t done = 0;
+		FILE *in = fopen(name, "rb");
+		if (!in)
+			return file_reader_fail(reader, "Failed to open input file",
+						name, NULL);
+
+		do {
+			double start = fel_stats_time();
+			chunk = upload_chunk_new(PIPELINE_CHUNK_SIZE);
+			chunk->size = fread(chunk->data, 1, PIPELINE_CHUNK_SIZE, in);
+			if (ferror(in)) {
+				upload_chunk_free(chunk);
+				return file_reader_fail(reader,
+							"Failed to read input file",
+							name, in);
+			}
+			fel_stats_since(FEL_STAT_FILE_READ, chunk->size, start);
+			if (done == 0) {
+				if (is_uEnv(chunk->data, chunk->size))
+					image_type = IH_TYPE_UENV;
+				else
+					image_type = get_image_type(chunk->data,
+								    chunk->size);
+			}
+			chunk->addr = offset + done;
+			chunk->progress = chunk->size;
+			chunk->index = i;
+			chunk->image_type = image_type;
+			chunk->last = chunk->size < PIPELINE_CHUNK_SIZE;
+			done += chunk->size;
+			chunk->total = done;
+			bqueue_push(reader->queue, chunk);
+		} while (!chunk->last);
+
+		fclose(in);
+	}
+	bqueue_close(reader->queue);
+	return NULL;
+}
+
+/*
+ * Small files get collected and uploaded with a single scatter transfer,
+ * which saves the FEL request overhead for each of them.
+ */
+#define SCATTER_MAX_FILE_SIZE	2048
+#define SCATTER_MAX_FILES	64
+
+typedef struct {
+	upload_chunk_t *chunks[SCATTER_MAX_FILES];
+	size_t count;
+} scatter_batch_t;
+
+static void scatter_batch_flush(feldev_handle *dev, scatter_batch_t *batch)
+{
+	fel_sg_entry sg[SCATTER_MAX_FILES];
+	size_t i, size = 0;
+
+	if (batch->count == 0)
+		return;
+	for (i = 0; i < batch->count; i++) {
+		sg[i].addr = batch->chunks[i]->addr;
+		sg[i].buf = batch->chunks[i]->data;
+		sg[i].len = batch->chunks[i]->size;
+		size += sg[i].len;
+	}
+	fel_scatter_write(dev, sg, batch->count, 0, 0);
+	progress_update(size);
+	for (i = 0; i < batch->count; i++)
+		upload_chunk_free(batch->chunks[i]);
+	batch->count = 0;
+}
+
 /* private helper function, gets used for "write*" and "multi*" transfers */
 static unsigned int file_upload(feldev_handle *dev, size_t count,
 				size_t argc, char **argv, progress_cb_t callback)
@@ -1179,21 +2078,341 @@ static unsigned int file_upload(feldev_handle *dev, size_t count,
 
 	progress_start(callback, size); /* set total size and progress callback */
 
-	/* now transfer each file in turn */
-	for (i = 0; i < count; i++) {
-		void *buf = load_file(argv[i * 2 + 1], &size);
-		if (size > 0) {
-			uint32_t offset = strtoul(argv[i * 2], NULL, 0);
-			aw_write_buffer(dev, buf, offset, size, callback != NULL);
+	file_reader_t reader = {
+		.count = count,
+		.argv = argv,
+		.queue = bqueue_new(PIPELINE_DEPTH),
+	};
+	pipeline_thread_t *thread = pipeline_thread_start(file_reader_thread,
+							  &reader);
+	scatter_batch_t batch = { .count = 0 };
+
+	/* USB sender stage: transfer each chunk in turn */
+	upload_chunk_t *chunk;
+	while ((chunk = bqueue_pop(reader.queue)) != NULL) {
+		uint32_t offset = chunk->addr + chunk->size - chunk->total;
+		int image_type = chunk->image_type;
+		size_t total = chunk->total;
+		bool last = chunk->last;
+
+		if (last && total == chunk->size &&
+		    total > 0 && total <= SCATTER_MAX_FILE_SIZE) {
+			/* small file: defer it for a combined scatter transfer */
+			check_uboot_overlap(chunk->addr, chunk->size);
+			if (batch.count == SCATTER_MAX_FILES)
+				scatter_batch_flush(dev, &batch);
+			batch.chunks[batch.count++] = chunk;
+		} else {
+			scatter_batch_flush(dev, &batch);
+			if (chunk->size > 0)
+				aw_write_buffer(dev, chunk->data, chunk->addr,
+						chunk->size, callback != NULL);
+			upload_chunk_free(chunk);
+		}
 
+		if (last && total > 0 && (image_type == IH_TYPE_SCRIPT ||
+					  image_type == IH_TYPE_UENV)) {
+			/* scatter transfers borrow the SRAM with the SPL header */
+			scatter_batch_flush(dev, &batch);
 			/* If we transferred a script, try to inform U-Boot about its address. */
-			if (get_image_type(buf, size) == IH_TYPE_SCRIPT)
+			if (image_type == IH_TYPE_SCRIPT)
 				pass_fel_information(dev, offset, 0);
-			if (is_uEnv(buf, size)) /* uEnv-style data */
-				pass_fel_information(dev, offset, size);
+			if (image_type == IH_TYPE_UENV) /* uEnv-style data */
+				pass_fel_information(dev, offset, total);
 		}
-		free(buf);
 	}
+	scatter_batch_flush(dev, &batch);
+
+	pipeline_thread_join(thread);
+	bqueue_free(reader.queue);
+	if (reader.error)
+		pr_fatal("%s %s: %s\n", reader.error, reader.error_file,
+			 strerror(reader.error_errno));
+
+	return i; /* return number of files that were processed */
+}
+
+/*
+ * "ramboot" command: put a kernel, and optionally an initrd and a DTB, into
+ * DRAM without overlaps, along with a generated boot script (or uEnv.txt).
+ * Everything goes through the file upload pipeline in one go, and U-Boot
+ * (from the "uboot" command) gets told about the script via the SPL header.
+ * The layout starts at the usual sunxi 'kernel_addr_r', and stays clear of
+ * an U-Boot image loaded before.
+ */
+#define RAMBOOT_BASE		(DRAM_BASE + 0x2000000)
+#define RAMBOOT_LIMIT		(DRAM_BASE + 0x10000000) /* 256 MiB boards */
+#define RAMBOOT_KERNEL_ALIGN	0x200000	/* arm64 "Image" */
+#define RAMBOOT_ALIGN		0x100000
+#define RAMBOOT_SCRIPT_SIZE	0x1000
+#define RAMBOOT_UBOOT_MIN_SIZE	0x200000	/* room for the BSS */
+#define RAMBOOT_CMDLINE		"console=ttyS0,115200 rdinit=/sbin/init panic=10"
+
+#define ZIMAGE_MAGIC		0x016F2818	/* at offset 0x24 */
+#define ARM64_IMAGE_MAGIC	"ARM\x64"	/* at offset 0x38 */
+#define FDT_MAGIC		0xd00dfeed
+
+typedef struct {
+	const char *kernel, *initrd, *dtb, *cmdline;
+	bool uenv;
+} ramboot_args_t;
+
+/* the number of values a "ramboot" option takes, or -1 if it is none */
+static int ramboot_option(const char *arg)
+{
+	if (strcmp(arg, "--kernel") == 0 || strcmp(arg, "--initrd") == 0 ||
+	    strcmp(arg, "--dtb") == 0 || strcmp(arg, "--cmdline") == 0)
+		return 1;
+	if (strcmp(arg, "--uenv") == 0)
+		return 0;
+	return -1;
+}
+
+/* parse the "ramboot" options, returns the number of arguments used */
+static int ramboot_parse(int argc, char **argv, ramboot_args_t *args)
+{
+	int i = 0, values;
+
+	memset(args, 0, sizeof(*args));
+	args->cmdline = RAMBOOT_CMDLINE;
+	while (i < argc && (values = ramboot_option(argv[i])) >= 0) {
+		if (i + values >= argc)
+			pr_fatal("ramboot: %s needs a value\n", argv[i]);
+		if (strcmp(argv[i], "--kernel") == 0)
+			args->kernel = argv[i + 1];
+		else if (strcmp(argv[i], "--initrd") == 0)
+			args->initrd = argv[i + 1];
+		else if (strcmp(argv[i], "--dtb") == 0)
+			args->dtb = argv[i + 1];
+		else if (strcmp(argv[i], "--cmdline") == 0)
+			args->cmdline = argv[i + 1];
+		else
+			args->uenv = true;
+		i += 1 + values;
+	}
+	if (!args->kernel)
+		pr_fatal("ramboot: --kernel is required\n");
+	return i;
+}
+
+static void read_file_head(const char *name, void *buf, size_t len)
+{
+	FILE *in = fopen(name, "rb");
+
+	memset(buf, 0, len);
+	if (!in)
+		pr_fatal("%s: %s\n", name, strerror(errno));
+	if (fread(buf, 1, len, in) == 0 && ferror(in))
+		pr_fatal("%s: read error\n", name);
+	fclose(in);
+}
+
+static uint32_t get_le32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | (uint32_t)p[1] << 8 |
+	       (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint32_t get_be32(const uint8_t *p)
+{
+	return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 |
+	       (uint32_t)p[2] << 8 | (uint32_t)p[3];
+}
+
+/* next free DRAM address for 'size' bytes, skipping the loaded U-Boot */
+static uint32_t ramboot_place(uint32_t *next, uint32_t size, uint32_t align)
+{
+	uint32_t addr = (*next + align - 1) & ~(align - 1), end;
+	const fit_range_t *r;
+	unsigned int i;
+
+	/* moving past one image may run into another, so start over then */
+	for (i = 0; i < uboot_range_count; i++) {
+		r = &uboot_ranges[i];
+		end = r->addr + (r->size > RAMBOOT_UBOOT_MIN_SIZE
+				 ? r->size : RAMBOOT_UBOOT_MIN_SIZE);
+		if (addr < end && addr + size > r->addr) {
+			addr = (end + align - 1) & ~(align - 1);
+			i = -1;
+		}
+	}
+	*next = addr + size;
+	return addr;
+}
+
+/* wrap a script into a legacy U-Boot image, as "mkimage -T script" does */
+static uint8_t *make_script_image(const char *text, size_t *size)
+{
+	size_t text_len = strlen(text);
+	uint8_t *image = calloc(1, HEADER_SIZE + 8 + text_len);
+	image_header_t *hdr = (image_header_t *)image;
+	uint32_t *lengths = (uint32_t *)(image + HEADER_SIZE);
+
+	if (!image)
+		pr_fatal("Failed to allocate the boot script\n");
+	lengths[0] = htobe32(text_len);	/* single script, zero terminated list */
+	memcpy(image + HEADER_SIZE + 8, text, text_len);
+
+	hdr->ih_magic = htobe32(IH_MAGIC);
+	hdr->ih_time = htobe32(time(NULL));
+	hdr->ih_size = htobe32(8 + text_len);
+	hdr->ih_dcrc = htobe32(crc32_update(0, lengths, 8 + text_len));
+	hdr->ih_os = IH_OS_LINUX;
+	hdr->ih_arch = IH_ARCH_ARM;
+	hdr->ih_type = IH_TYPE_SCRIPT;
+	strncpy((char *)hdr->ih_name, "sunxi-fel ramboot", IH_NMLEN);
+	hdr->ih_hcrc = htobe32(crc32_update(0, hdr, HEADER_SIZE));
+
+	*size = HEADER_SIZE + 8 + text_len;
+	return image;
+}
+
+static int aw_fel_ramboot(feldev_handle *dev, int argc, char **argv,
+			  progress_cb_t callback)
+{
+	ramboot_args_t args;
+	uint8_t head[64];
+	char addrs[3][16], initrd_arg[32], dtb_arg[32], bootcmd[128];
+	char *text, *upload[6];
+	const char *boot = NULL;
+	uint32_t next = RAMBOOT_BASE, kernel_size, kernel_addr, script_addr;
+	uint32_t initrd_addr = 0, dtb_addr = 0, initrd_size = 0;
+	uint8_t *script;
+	size_t script_size, count = 0;
+	int used = ramboot_parse(argc, argv, &args);
+
+	/* kernel: legacy uImage, ARM zImage or arm64 Image */
+	kernel_size = file_size(args.kernel);
+	read_file_head(args.kernel, head, sizeof(head));
+	if (get_be32(head) == IH_MAGIC) {
+		boot = "bootm";
+	} else if (get_le32(head + 0x24) == ZIMAGE_MAGIC) {
+		boot = "bootz";
+	} else if (memcmp(head + 0x38, ARM64_IMAGE_MAGIC, 4) == 0) {
+		/* reserve the "image_size" (including BSS) if given */
+		if (get_le32(head + 0x14) == 0 &&
+		    get_le32(head + 0x10) > kernel_size)
+			kernel_size = get_le32(head + 0x10);
+		boot = "booti";
+	} else {
+		pr_fatal("ramboot: %s: unknown kernel format\n", args.kernel);
+	}
+	kernel_addr = ramboot_place(&next, kernel_size, RAMBOOT_KERNEL_ALIGN);
+	snprintf(addrs[count], sizeof(addrs[count]), "0x%08X", kernel_addr);
+	upload[count * 2] = addrs[count];
+	upload[count++ * 2 + 1] = (char *)args.kernel;
+
+	strcpy(dtb_arg, "${fdtcontroladdr}");	/* U-Boot's own DT */
+	if (args.dtb) {
+		read_file_head(args.dtb, head, sizeof(head));
+		if (get_be32(head) != FDT_MAGIC)
+			pr_fatal("ramboot: %s: not a DTB\n", args.dtb);
+		dtb_addr = ramboot_place(&next, file_size(args.dtb),
+					 RAMBOOT_ALIGN);
+		snprintf(dtb_arg, sizeof(dtb_arg), "0x%08X", dtb_addr);
+		snprintf(addrs[count], sizeof(addrs[count]), "0x%08X", dtb_addr);
+		upload[count * 2] = addrs[count];
+		upload[count++ * 2 + 1] = (char *)args.dtb;
+	}
+
+	/* the script gets generated once the layout is known */
+	script_addr = ramboot_place(&next, RAMBOOT_SCRIPT_SIZE,
+				    RAMBOOT_SCRIPT_SIZE);
+
+	strcpy(initrd_arg, "-");
+	if (args.initrd) {
+		initrd_size = file_size(args.initrd);
+		read_file_head(args.initrd, head, sizeof(head));
+		initrd_addr = ramboot_place(&next, initrd_size, RAMBOOT_ALIGN);
+		/* raw initrds need the size, uImage ramdisks have a header */
+		if (get_be32(head) == IH_MAGIC)
+			snprintf(initrd_arg, sizeof(initrd_arg), "0x%08X",
+				 initrd_addr);
+		else
+			snprintf(initrd_arg, sizeof(initrd_arg), "0x%08X:0x%X",
+				 initrd_addr, initrd_size);
+		snprintf(addrs[count], sizeof(addrs[count]), "0x%08X",
+			 initrd_addr);
+		upload[count * 2] = addrs[count];
+		upload[count++ * 2 + 1] = (char *)args.initrd;
+	}
+	if (next > RAMBOOT_LIMIT)
+		pr_error("Warning: ramboot images end at 0x%08X, beyond the "
+			 "DRAM of small (256 MiB) boards\n", next);
+
+	snprintf(bootcmd, sizeof(bootcmd), "%s 0x%08X %s %s", boot,
+		 kernel_addr, initrd_arg, dtb_arg);
+	if (args.uenv) {
+		if (strchr(args.cmdline, '\n'))
+			pr_fatal("ramboot: the command line can't be multi-line\n");
+		text = malloc(strlen(args.cmdline) + strlen(bootcmd) + 64);
+		if (!text)
+			pr_fatal("Failed to allocate the boot script\n");
+		sprintf(text, "#=uEnv\nbootargs=%s\nbootcmd=%s\n",
+			args.cmdline, bootcmd);
+		script = (uint8_t *)text;
+		script_size = strlen(text);
+	} else {
+		if (strchr(args.cmdline, '\''))
+			pr_fatal("ramboot: the command line can't contain \"'\"\n");
+		text = malloc(strlen(args.cmdline) + strlen(bootcmd) + 64);
+		if (!text)
+			pr_fatal("Failed to allocate the boot script\n");
+		sprintf(text, "# sunxi-fel ramboot\nsetenv bootargs '%s'\n%s\n",
+			args.cmdline, bootcmd);
+		script = make_script_image(text, &script_size);
+		free(text);
+	}
+	if (script_size > RAMBOOT_SCRIPT_SIZE)
+		pr_fatal("ramboot: the boot script is too large\n");
+
+	pr_info("ramboot: kernel at 0x%08X (%s), initrd at 0x%08X, "
+		"DTB at 0x%08X, %s at 0x%08X\n", kernel_addr, boot,
+		initrd_addr, dtb_addr, args.uenv ? "uEnv" : "boot script",
+		script_addr);
+	if (!have_sunxi_spl(dev, dev->soc_info->spl_addr))
+		pr_error("Warning: no sunxi SPL header, U-Boot won't find the "
+			 "ramboot %s\n", args.uenv ? "uEnv" : "boot script");
+
+	/* the script is tiny, and gets written along with the first file */
+	check_uboot_overlap(script_addr, script_size);
+	aw_fel_write(dev, script, script_addr, script_size);
+	file_upload(dev, count, count * 2, upload, callback);
+	pass_fel_information(dev, script_addr, args.uenv ? script_size : 0);
+	free(script);
+
+	return used;
+}
+
+/*
+ * "multiread" command: read several (small) memory regions to files,
+ * gathering them on the device to save FEL requests.
+ */
+static unsigned int file_download(feldev_handle *dev, size_t count,
+				  size_t argc, char **argv)
+{
+	fel_sg_entry *sg;
+	unsigned int i;
+
+	if (argc < count * 3)
+		pr_fatal("error: too few arguments for reading %zu files\n",
+			 count);
+	sg = calloc(count, sizeof(*sg));
+	if (!sg)
+		pr_fatal("Failed to allocate scatter/gather list\n");
+	for (i = 0; i < count; i++) {
+		sg[i].addr = strtoul(argv[i * 3], NULL, 0);
+		sg[i].len = strtoul(argv[i * 3 + 1], NULL, 0);
+		sg[i].buf = malloc(sg[i].len);
+		if (!sg[i].buf)
+			pr_fatal("Failed to allocate read buffer\n");
+	}
+	fel_gather_read(dev, sg, count, 0, 0);
+	for (i = 0; i < count; i++) {
+		save_file(argv[i * 3 + 2], sg[i].buf, sg[i].len);
+		free(sg[i].buf);
+	}
+	free(sg);
 
 	return i; /* return number of files that were processed */
 }
@@ -1250,6 +2469,12 @@ void usage(const char *cmd) {
 		"	-d, --dev bus:devnum		Use specific USB bus and device number\n"
 		"	    --sid SID			Select device by SID key (exact match)\n"
 		"	    --list-socs			Print a list of all supported SoCs\n"
+		"	    --stats FILE		Write transfer metrics (JSON) to FILE\n"
+		"	    --timeline FILE		Write a timeline of commands and boot steps\n"
+		"					(Chrome trace JSON) to FILE, and as text to stderr\n"
+		"	    --mmu			Enable the MMU and caches for faster transfers\n"
+		"	    --cache			Keep decompressed FIT images in a cache\n"
+		"					(~/.cache/sunxi-tools) for later runs\n"
 		"\n"
 		"	spl file			Load and execute U-Boot SPL\n"
 		"		If file additionally contains a main U-Boot binary\n"
@@ -1260,9 +2485,18 @@ void usage(const char *cmd) {
 		"		U-Boot execution will take place when the fel utility exits.\n"
 		"		This allows combining \"uboot\" with further \"write\" commands\n"
 		"		(to transfer other files needed for the boot).\n"
+		"	ramboot --kernel file [--initrd file] [--dtb file]\n"
+		"		[--cmdline \"args\"] [--uenv]\n"
+		"		Place the files in DRAM, generate a boot script (or uEnv.txt)\n"
+		"		for them, upload everything and pass it to U-Boot. Combine\n"
+		"		with \"uboot\" to boot Linux from RAM.\n"
 		"\n"
 		"	hex[dump] address length	Dumps memory region in hex\n"
+		"	hex16 address length		Hex dump as 16-bit words\n"
+		"	hex32 address length		Hex dump as 32-bit words\n"
 		"	dump address length		Binary memory dump\n"
+		"	mmio-dump address length	Dump registers (32-bit accesses) as hex\n"
+		"	mmio-save address length file	Save registers (32-bit accesses) to file\n"
 		"	exe[cute] address		Call function address\n"
 		"	reset64 address			RMR request for AArch64 warm boot\n"
 		"	wdreset				Reboot via watchdog\n"
@@ -1270,6 +2504,8 @@ void usage(const char *cmd) {
 		"	readl address			Read 32-bit value from device memory\n"
 		"	writel address value		Write 32-bit value to device memory\n"
 		"	read address length file	Write memory contents into file\n"
+		"	multiread # addr length file ...	\"read\" multiple (small) regions,\n"
+		"					gathered with a single transfer\n"
 		"	write address file		Store file contents into memory\n"
 		"	write-with-progress addr file	\"write\" with progress bar\n"
 		"	write-with-gauge addr file	Output progress for \"dialog --gauge\"\n"
@@ -1287,6 +2523,10 @@ void usage(const char *cmd) {
 		"	sid-dump			Dump the content of all the SID eFuses\n"
 		"	clear address length		Clear memory\n"
 		"	fill address length value	Fill memory\n"
+		"	bench				Measure FEL latency and throughput (SRAM)\n"
+		"	bench-dram address size		Like bench, plus the given DRAM region\n"
+		"	membench address size		On-device memory bandwidth/latency\n"
+		"					benchmark (overwrites the DRAM region)\n"
 		, cmd);
 	printf("\n");
 	aw_fel_spiflash_help();
@@ -1299,6 +2539,7 @@ int main(int argc, char **argv)
 	bool pflag_active = false; /* -p switch, causing "write" to output progress */
 	bool device_list = false; /* -l switch, prints device list and exits */
 	bool socs_list = false; /* list all supported SoCs and exit */
+	bool mmu_setup = false; /* enable MMU and caches, with --mmu */
 	feldev_handle *handle;
 	int busnum = -1, devnum = -1;
 	char *sid_arg = NULL;
@@ -1337,6 +2578,18 @@ int main(int argc, char **argv)
 			sid_arg = argv[2];
 			argc -= 1;
 			argv += 1;
+		} else if (strcmp(argv[1], "--stats") == 0 && argc > 2) {
+			fel_stats_open(argv[2]);
+			argc -= 1;
+			argv += 1;
+		} else if (strcmp(argv[1], "--timeline") == 0 && argc > 2) {
+			fel_stats_timeline_open(argv[2]);
+			argc -= 1;
+			argv += 1;
+		} else if (strcmp(argv[1], "--mmu") == 0) {
+			mmu_setup = true;
+		} else if (strcmp(argv[1], "--cache") == 0) {
+			artifact_cache_enable();
 		} else
 			break; /* no valid (prefix) option detected, exit loop */
 		argc -= 1;
@@ -1351,9 +2604,16 @@ int main(int argc, char **argv)
 	 * confusing the user, bail out here - with a more descriptive message.
 	 */
 	int i;
-	for (i = 1; i < argc; i++)
+	for (i = 1; i < argc; i++) {
+		/* skip the options of the "ramboot" command, and their values */
+		if (strcmp(argv[i], "ramboot") == 0) {
+			while (i + 1 < argc && ramboot_option(argv[i + 1]) >= 0)
+				i += 1 + ramboot_option(argv[i + 1]);
+			continue;
+		}
 		if (*argv[i] == '-')
 			pr_fatal("Invalid option %s\n", argv[i]);
+	}
 
 	/* Process options that don't require a FEL device handle */
 	if (device_list)
@@ -1380,24 +2640,66 @@ int main(int argc, char **argv)
 	 * the first one matching the given USB vendor/procduct ID.
 	 */
 	handle = feldev_open(busnum, devnum, AW_USB_VENDOR_ID, AW_USB_PRODUCT_ID);
+	fel_stats_set_device(handle->soc_name, handle->soc_version.soc_id);
 
 	/* Some SoCs need the SMC workaround to enter the secure boot mode */
 	aw_apply_smc_workaround(handle);
 
+	/* run the BROM code cached, for faster transfers */
+	if (mmu_setup) {
+		fel_stats_phase_begin("mmu-setup");
+		aw_mmu_auto_setup(handle);
+		fel_stats_phase_end();
+	}
+
+	/* with --stats/--timeline, also profile remote functions (device CPU cycles) */
+	if (fel_stats_enabled)
+		aw_fel_remotefunc_profiling(handle, true);
+
 	/* Handle command-style arguments, in order of appearance */
 	while (argc > 1 ) {
 		int skip = 1;
 
-		if (strncmp(argv[1], "hex", 3) == 0 && argc > 3) {
-			aw_fel_hexdump(handle, strtoul(argv[2], NULL, 0), strtoul(argv[3], NULL, 0));
+		fel_stats_command(argv[1]);
+
+		if (strcmp(argv[1], "hex16") == 0 && argc > 3) {
+			aw_fel_hexdump(handle, strtoul(argv[2], NULL, 0), strtoul(argv[3], NULL, 0), 2);
+			skip = 3;
+		} else if (strcmp(argv[1], "hex32") == 0 && argc > 3) {
+			aw_fel_hexdump(handle, strtoul(argv[2], NULL, 0), strtoul(argv[3], NULL, 0), 4);
+			skip = 3;
+		} else if (strncmp(argv[1], "hex", 3) == 0 && argc > 3) {
+			aw_fel_hexdump(handle, strtoul(argv[2], NULL, 0), strtoul(argv[3], NULL, 0), 1);
 			skip = 3;
 		} else if (strncmp(argv[1], "dump", 4) == 0 && argc > 3) {
 			aw_fel_dump(handle, strtoul(argv[2], NULL, 0), strtoul(argv[3], NULL, 0));
 			skip = 3;
+		} else if (strcmp(argv[1], "mmio-dump") == 0 && argc > 3) {
+			aw_fel_mmio_dump(handle, strtoul(argv[2], NULL, 0),
+					 strtoul(argv[3], NULL, 0), NULL);
+			skip = 3;
+		} else if (strcmp(argv[1], "mmio-save") == 0 && argc > 4) {
+			aw_fel_mmio_dump(handle, strtoul(argv[2], NULL, 0),
+					 strtoul(argv[3], NULL, 0), argv[4]);
+			skip = 4;
+		} else if (strcmp(argv[1], "bench") == 0) {
+			aw_fel_bench(handle, 0, 0);
+		} else if (strcmp(argv[1], "bench-dram") == 0 && argc > 3) {
+			/* a region (e.g. DRAM) to benchmark in addition */
+			aw_fel_bench(handle, strtoul(argv[2], NULL, 0),
+				     strtoul(argv[3], NULL, 0));
+			skip = 3;
+		} else if (strcmp(argv[1], "membench") == 0 && argc > 3) {
+			aw_fel_membench(handle, strtoul(argv[2], NULL, 0),
+					strtoul(argv[3], NULL, 0));
+			skip = 3;
 		} else if (strcmp(argv[1], "memmove") == 0 && argc > 4) {
 			/* three parameters: destination addr, source addr, byte count */
-			fel_memmove(handle, strtoul(argv[2], NULL, 0),
-				    strtoul(argv[3], NULL, 0), strtoul(argv[4], NULL, 0));
+			uint32_t dst = strtoul(argv[2], NULL, 0);
+			uint32_t src = strtoul(argv[3], NULL, 0);
+			size_t size = strtoul(argv[4], NULL, 0);
+			if (!aw_fel_dma_copy(handle, dst, src, size))
+				fel_memmove(handle, dst, src, size);
 			skip = 4;
 		} else if (strcmp(argv[1], "readl") == 0 && argc > 2) {
 			printf("0x%08x\n", fel_readl(handle, strtoul(argv[2], NULL, 0)));
@@ -1461,6 +2763,10 @@ int main(int argc, char **argv)
 			save_file(argv[4], buf, size);
 			free(buf);
 			skip=4;
+		} else if ((strcmp(argv[1], "multiread") == 0) && argc > 5) {
+			size_t count = strtoul(argv[2], NULL, 0); /* file count */
+			skip = 2 + 3 * file_download(handle, count, argc - 3,
+						     argv + 3);
 		} else if (strcmp(argv[1], "clear") == 0 && argc > 2) {
 			aw_fel_fill(handle, strtoul(argv[2], NULL, 0), strtoul(argv[3], NULL, 0), 0);
 			skip=3;
@@ -1468,14 +2774,19 @@ int main(int argc, char **argv)
 			aw_fel_fill(handle, strtoul(argv[2], NULL, 0), strtoul(argv[3], NULL, 0), (unsigned char)strtoul(argv[4], NULL, 0));
 			skip=4;
 		} else if (strcmp(argv[1], "spl") == 0 && argc > 2) {
-			aw_fel_process_spl_and_uboot(handle, argv[2]);
+			aw_fel_process_spl_and_uboot(handle, argv[2],
+					pflag_active ? progress_bar : NULL);
 			skip=2;
 		} else if (strcmp(argv[1], "uboot") == 0 && argc > 2) {
-			aw_fel_process_spl_and_uboot(handle, argv[2]);
-			uboot_autostart = (uboot_entry > 0 && uboot_size > 0);
+			aw_fel_process_spl_and_uboot(handle, argv[2],
+					pflag_active ? progress_bar : NULL);
+			uboot_autostart = (uboot_entry > 0 && uboot_range_count > 0);
 			if (!uboot_autostart)
 				printf("Warning: \"uboot\" command failed to detect image! Can't execute U-Boot.\n");
 			skip=2;
+		} else if (strcmp(argv[1], "ramboot") == 0) {
+			skip += aw_fel_ramboot(handle, argc - 2, argv + 2,
+					pflag_active ? progress_bar : NULL);
 		} else if (strcmp(argv[1], "spiflash-info") == 0) {
 			aw_fel_spiflash_info(handle);
 		} else if (strcmp(argv[1], "spiflash-read") == 0 && argc > 4) {
@@ -1502,11 +2813,14 @@ int main(int argc, char **argv)
 
 	/* auto-start U-Boot if requested (by the "uboot" command) */
 	if (uboot_autostart) {
+		fel_stats_command("uboot-start");
 		pr_info("Starting U-Boot (0x%08X).\n", uboot_entry);
+		fel_stats_phase_begin(enter_in_aarch64 ? "uboot:rmr" : "uboot:exec");
 		if (enter_in_aarch64)
 			aw_rmr_request(handle, uboot_entry, true);
 		else
 			aw_fel_execute(handle, uboot_entry);
+		fel_stats_phase_end();
 	}
 
 	feldev_done(handle);
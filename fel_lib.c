@@ -23,6 +23,7 @@
 
 #include "portable_endian.h"
 #include "fel_lib.h"
+#include "fel_stats.h"
 #include <libusb.h>
 
 #include <assert.h>
@@ -30,10 +31,22 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #define USB_TIMEOUT	10000 /* 10 seconds */
 
+/*
+ * Size of the write-combining buffer. Small aw_fel_write() calls to adjacent
+ * (or overlapping) addresses get collected here, and are sent to the device
+ * as a single FEL write request. Writes of this size or larger bypass the
+ * buffer.
+ */
+#define AW_WC_BUFFER_SIZE	(64 * 1024)
+
 static bool fel_lib_initialized = false;
+/* device whose pending writes get flushed at exit (e.g. after pr_fatal) */
+static feldev_handle *exit_flush_dev;
+static bool exit_flushing, exit_flushing_registered;
 
 /* This is out 'private' data type that will be part of a "FEL device" handle */
 struct _felusb_handle {
@@ -41,6 +54,15 @@ struct _felusb_handle {
 	int endpoint_out, endpoint_in;
 	bool iface_detached;
 	bool icache_hacked;
+	/* called before the first write to [addr, addr + size) */
+	struct {
+		void (*callback)(feldev_handle *dev);
+		uint32_t addr, size;
+	} guard[AW_FEL_GUARDS];
+	/* pending (not yet transferred) write data */
+	uint32_t wc_addr;
+	size_t wc_len;
+	uint8_t wc_buf[AW_WC_BUFFER_SIZE];
 };
 
 /* a helper function to report libusb errors */
@@ -56,6 +78,8 @@ static void usb_error(int rc, const char *caption, int exitcode)
 	fprintf(stderr, "ERROR %d\n", rc);
 #endif
 
+	if (exitcode != 0 && exit_flushing)
+		_exit(exitcode); /* already exiting, don't run atexit() again */
 	if (exitcode != 0)
 		exit(exitcode);
 }
@@ -182,20 +206,40 @@ static void aw_send_fel_request(feldev_handle *dev, int type,
 		.address = htole32(addr),
 		.length = htole32(length)
 	};
+	double start = fel_stats_time();
 	aw_usb_write(dev, &req, sizeof(req), false);
+	fel_stats_since(FEL_STAT_REQUEST, sizeof(req), start);
 }
 
 static void aw_read_fel_status(feldev_handle *dev)
 {
 	char buf[8];
+	double start = fel_stats_time();
 	aw_usb_read(dev, buf, sizeof(buf));
+	fel_stats_since(FEL_STAT_STATUS, sizeof(buf), start);
+}
+
+/* data phase transfers, with accounting */
+static void aw_fel_data_write(feldev_handle *dev, const void *buf, size_t len,
+			      bool progress)
+{
+	double start = fel_stats_time();
+	aw_usb_write(dev, buf, len, progress);
+	fel_stats_since(FEL_STAT_WRITE, len, start);
+}
+
+static void aw_fel_data_read(feldev_handle *dev, void *buf, size_t len)
+{
+	double start = fel_stats_time();
+	aw_usb_read(dev, buf, len);
+	fel_stats_since(FEL_STAT_READ, len, start);
 }
 
 /* AW_FEL_VERSION request */
 static void aw_fel_get_version(feldev_handle *dev, struct aw_fel_version *buf)
 {
 	aw_send_fel_request(dev, AW_FEL_VERSION, 0, 0);
-	aw_usb_read(dev, buf, sizeof(*buf));
+	aw_fel_data_read(dev, buf, sizeof(*buf));
 	aw_read_fel_status(dev);
 
 	buf->soc_id = (le32toh(buf->soc_id) >> 8) & 0xFFFF;
@@ -206,30 +250,111 @@ static void aw_fel_get_version(feldev_handle *dev, struct aw_fel_version *buf)
 	buf->pad[1] = le32toh(buf->pad[1]);
 }
 
-/* AW_FEL_1_READ request */
-void aw_fel_read(feldev_handle *dev, uint32_t offset, void *buf, size_t len)
-{
-	aw_send_fel_request(dev, AW_FEL_1_READ, offset, len);
-	aw_usb_read(dev, buf, len);
-	aw_read_fel_status(dev);
-}
-
 /* AW_FEL_1_WRITE request */
 static void aw_fel_write_raw(feldev_handle *dev, const void *buf, uint32_t offset, size_t len)
 {
 	if (len == 0)
 		return;
 
+	/* account for ARM code uploads */
+	if (fel_stats_enabled && (offset == dev->soc_info->scratch_addr ||
+				  offset == dev->soc_info->thunk_addr))
+		fel_stats_add(FEL_STAT_THUNK, len, 0.);
+
 	aw_send_fel_request(dev, AW_FEL_1_WRITE, offset, len);
-	aw_usb_write(dev, buf, len, false);
+	aw_fel_data_write(dev, buf, len, false);
+	aw_read_fel_status(dev);
+}
+
+/*
+ * Transfer any pending write data to the device. This happens automatically
+ * before executing code, before any read (so e.g. a status register read
+ * can't overtake an MMIO write) and when the program exits. Callers that
+ * rely on side effects of a write (e.g. to MMIO registers) without a
+ * subsequent read or execute should call this explicitly.
+ */
+void aw_fel_flush(feldev_handle *dev)
+{
+	felusb_handle *usb = dev->usb;
+
+	if (usb->wc_len > 0) {
+		size_t len = usb->wc_len;
+		usb->wc_len = 0;
+		aw_fel_write_raw(dev, usb->wc_buf, usb->wc_addr, len);
+	}
+}
+
+/* don't lose buffered writes if the program exits, e.g. via pr_fatal() */
+static void aw_fel_flush_at_exit(void)
+{
+	if (exit_flush_dev) {
+		exit_flushing = true;
+		aw_fel_flush(exit_flush_dev);
+	}
+}
+
+/* AW_FEL_1_READ request */
+void aw_fel_read(feldev_handle *dev, uint32_t offset, void *buf, size_t len)
+{
+	/* a read is a round trip anyway, keep it ordered after all writes */
+	aw_fel_flush(dev);
+
+	aw_send_fel_request(dev, AW_FEL_1_READ, offset, len);
+	aw_fel_data_read(dev, buf, len);
 	aw_read_fel_status(dev);
 }
 
 /* AW_FEL_1_EXEC request */
 void aw_fel_execute(feldev_handle *dev, uint32_t offset)
 {
+	aw_fel_flush(dev);
+	double start = fel_stats_time();
 	aw_send_fel_request(dev, AW_FEL_1_EXEC, offset, 0);
 	aw_read_fel_status(dev);
+	fel_stats_since(FEL_STAT_EXECUTE, 0, start);
+}
+
+/*
+ * Collect write data in the write-combining buffer. A new write gets merged
+ * if it overlaps or directly adjoins the pending range (later data wins),
+ * otherwise the pending data is flushed first.
+ */
+static void aw_fel_write_combined(feldev_handle *dev, const void *buf,
+				  uint32_t offset, size_t len)
+{
+	felusb_handle *usb = dev->usb;
+
+	if (len == 0)
+		return;
+
+	if (usb->wc_len > 0) {
+		uint32_t start = offset < usb->wc_addr ? offset : usb->wc_addr;
+		uint64_t end = (uint64_t)usb->wc_addr + usb->wc_len;
+
+		if ((uint64_t)offset + len > end)
+			end = (uint64_t)offset + len;
+		if (offset <= usb->wc_addr + usb->wc_len &&
+		    usb->wc_addr <= offset + len &&
+		    end - start <= AW_WC_BUFFER_SIZE) {
+			/* merge: move existing data up if we extend downwards */
+			if (start < usb->wc_addr)
+				memmove(usb->wc_buf + (usb->wc_addr - start),
+					usb->wc_buf, usb->wc_len);
+			memcpy(usb->wc_buf + (offset - start), buf, len);
+			usb->wc_addr = start;
+			usb->wc_len = end - start;
+			return;
+		}
+		aw_fel_flush(dev);
+	}
+
+	if (len >= AW_WC_BUFFER_SIZE) {
+		aw_fel_write_raw(dev, buf, offset, len);
+		return;
+	}
+	memcpy(usb->wc_buf, buf, len);
+	usb->wc_addr = offset;
+	usb->wc_len = len;
 }
 
 static void aw_disable_icache(feldev_handle *dev)
@@ -246,17 +371,60 @@ static void aw_disable_icache(feldev_handle *dev)
 		htole32(0xf57ff06f), /* isb sy */
 		htole32(0xe12fff1e), /* bx  lr */
 	};
+	aw_fel_flush(dev);
 	aw_fel_write_raw(dev, arm_code, soc_info->scratch_addr, sizeof(arm_code));
 	aw_fel_execute(dev, soc_info->scratch_addr);
 }
 
+/*
+ * Have 'callback' invoked once, right before the first write that overlaps
+ * [addr, addr + size). E.g. the MMU gets disabled that way before its
+ * translation table is overwritten. A NULL 'callback' removes the guard.
+ * There is one guard per 'slot' (AW_FEL_GUARD_*). Host writes get caught
+ * automatically; the library's device-side copies (memmove, scatter, DMA)
+ * report their destination via aw_fel_device_write().
+ */
+void aw_fel_set_write_guard(feldev_handle *dev, unsigned int slot,
+			    uint32_t addr, uint32_t size,
+			    void (*callback)(feldev_handle *dev))
+{
+	assert(slot < AW_FEL_GUARDS);
+	dev->usb->guard[slot].callback = callback;
+	dev->usb->guard[slot].addr = addr;
+	dev->usb->guard[slot].size = size;
+}
+
+/*
+ * Announce that code on the device is about to write [offset, offset + len).
+ * Call this before uploading that code, since a guard callback is free to
+ * use the scratch area.
+ */
+void aw_fel_device_write(feldev_handle *dev, uint32_t offset, size_t len)
+{
+	felusb_handle *usb = dev->usb;
+	void (*callback)(feldev_handle *dev);
+	unsigned int i;
+
+	for (i = 0; i < AW_FEL_GUARDS; i++) {
+		callback = usb->guard[i].callback;
+		if (!callback || len == 0 ||
+		    offset >= usb->guard[i].addr + usb->guard[i].size ||
+		    usb->guard[i].addr >= offset + len)
+			continue;
+		/* disarm first, the callback is free to write to the device */
+		usb->guard[i].callback = NULL;
+		callback(dev);
+	}
+}
+
 void aw_fel_write(feldev_handle *dev, const void *buf, uint32_t offset, size_t len)
 {
+	aw_fel_device_write(dev, offset, len);
 	if (dev->soc_info->icache_fix && !dev->usb->icache_hacked) {
 		aw_disable_icache(dev);
 		dev->usb->icache_hacked = true;
 	}
-	aw_fel_write_raw(dev, buf, offset, len);
+	aw_fel_write_combined(dev, buf, offset, len);
 }
 
 /*
@@ -270,8 +438,10 @@ void aw_fel_write_buffer(feldev_handle *dev, const void *buf, uint32_t offset,
 	if (len == 0)
 		return;
 
+	aw_fel_device_write(dev, offset, len);
+	aw_fel_flush(dev); /* keep the order of writes intact */
 	aw_send_fel_request(dev, AW_FEL_1_WRITE, offset, len);
-	aw_usb_write(dev, buf, len, progress);
+	aw_fel_data_write(dev, buf, len, progress);
 	aw_read_fel_status(dev);
 }
 
@@ -285,6 +455,38 @@ void aw_fel_write_buffer(feldev_handle *dev, const void *buf, uint32_t offset,
 #define LCODE_MAX_TOTAL  0x100 /* max. words in buffer */
 #define LCODE_MAX_WORDS  (LCODE_MAX_TOTAL - LCODE_ARM_WORDS) /* data words */
 
+/*
+ * Some operations need a temporary data buffer on the device. They borrow
+ * the SRAM between spl_addr and scratch_addr (max. 4 KiB), saving its
+ * content first and restoring it afterwards.
+ */
+#define SRAM_STAGING_MAX	0x1000
+
+static size_t sram_staging_size(feldev_handle *dev)
+{
+	size_t size = dev->soc_info->scratch_addr - dev->soc_info->spl_addr;
+	return size > SRAM_STAGING_MAX ? SRAM_STAGING_MAX : size;
+}
+
+static void *sram_staging_backup(feldev_handle *dev)
+{
+	size_t size = sram_staging_size(dev);
+	void *backup = malloc(size);
+	if (!backup) {
+		fprintf(stderr, "FAILED to allocate SRAM backup buffer.\n");
+		exit(1);
+	}
+	aw_fel_read(dev, dev->soc_info->spl_addr, backup, size);
+	return backup;
+}
+
+static void sram_staging_restore(feldev_handle *dev, void *backup)
+{
+	aw_fel_write(dev, backup, dev->soc_info->spl_addr,
+		     sram_staging_size(dev));
+	free(backup);
+}
+
 /* multiple "readl" from sequential addresses to a destination buffer */
 static void aw_fel_readl_n(feldev_handle *dev, uint32_t addr,
 			   uint32_t *dst, size_t count)
@@ -343,6 +545,77 @@ void fel_readl_n(feldev_handle *dev, uint32_t addr, uint32_t *dst, size_t count)
 	}
 }
 
+/*
+ * Word-wise read of larger (MMIO) areas, e.g. to snapshot whole register
+ * blocks. Unlike fel_readl_n(), the ARM code stays resident in the scratch
+ * area and copies up to 4 KiB per call to the SRAM staging buffer. It also
+ * advances the source address on its own, so each batch only needs an
+ * "execute" and a "read" request.
+ */
+#define BULK_ARM_WORDS	13 /* word count of the resident copy loop */
+
+void fel_readl_bulk(feldev_handle *dev, uint32_t addr, uint32_t *dst,
+		    size_t count)
+{
+	soc_info_t *soc_info = dev->soc_info;
+	size_t batch = sram_staging_size(dev) / sizeof(uint32_t);
+	size_t n, i;
+
+	/* not worth it, or would clobber our own staging buffer / code */
+	if (count <= LCODE_MAX_WORDS || batch <= LCODE_MAX_WORDS ||
+	    (addr < soc_info->scratch_addr + LCODE_MAX_TOTAL * sizeof(uint32_t)
+	     && soc_info->spl_addr < addr + count * sizeof(uint32_t))) {
+		fel_readl_n(dev, addr, dst, count);
+		return;
+	}
+
+	uint32_t arm_code[] = {
+		htole32(0xe59f0020), /*    0:  ldr   r0, [pc, #32] ; src_addr  */
+		htole32(0xe59f1020), /*    4:  ldr   r1, [pc, #32] ; staging   */
+		htole32(0xe59f2020), /*    8:  ldr   r2, [pc, #32] ; count     */
+		/* <bulk_loop>: */
+		htole32(0xe2522001), /*    c:  subs  r2, r2, #1                */
+		htole32(0x4a000002), /*   10:  bmi   20 <bulk_done>            */
+		htole32(0xe4903004), /*   14:  ldr   r3, [r0], #4              */
+		htole32(0xe4813004), /*   18:  str   r3, [r1], #4              */
+		htole32(0xeafffffa), /*   1c:  b     c <bulk_loop>             */
+		/* <bulk_done>: */
+		htole32(0xe58f0000), /*   20:  str   r0, [pc]      ; src_addr  */
+		htole32(0xe12fff1e), /*   24:  bx    lr                        */
+
+		htole32(addr),			/* src_addr, advanced by code */
+		htole32(soc_info->spl_addr),	/* staging buffer */
+		htole32(batch),			/* word count */
+	};
+	assert(sizeof(arm_code) == BULK_ARM_WORDS * sizeof(uint32_t));
+
+	void *backup = sram_staging_backup(dev);
+	uint32_t *buffer = malloc(batch * sizeof(uint32_t));
+	if (!buffer) {
+		fprintf(stderr, "FAILED to allocate readl_bulk buffer.\n");
+		exit(1);
+	}
+
+	aw_fel_write(dev, arm_code, soc_info->scratch_addr, sizeof(arm_code));
+	while (count > 0) {
+		n = count > batch ? batch : count;
+		if (n < batch) { /* adjust word count for the last batch */
+			uint32_t last = htole32(n);
+			aw_fel_write(dev, &last, soc_info->scratch_addr +
+				     (BULK_ARM_WORDS - 1) * sizeof(uint32_t),
+				     sizeof(last));
+		}
+		aw_fel_execute(dev, soc_info->scratch_addr);
+		aw_fel_read(dev, soc_info->spl_addr, buffer,
+			    n * sizeof(uint32_t));
+		for (i = 0; i < n; i++)
+			*dst++ = le32toh(buffer[i]);
+		count -= n;
+	}
+	free(buffer);
+	sram_staging_restore(dev, backup);
+}
+
 /* multiple "writel" from a source buffer to sequential addresses */
 static void aw_fel_writel_n(feldev_handle *dev, uint32_t addr,
 			    uint32_t *src, size_t count)
@@ -405,117 +678,282 @@ void fel_writel_n(feldev_handle *dev, uint32_t addr, uint32_t *src, size_t count
 /*
  * move (arbitrary byte count) data between addresses within SoC memory
  *
- * These functions try to copy as many bytes as possible using 32-bit word
- * transfers, and handle any unaligned bytes ('head' and 'tail') separately.
+ * The copy engine (thunks/memcpy.S) moves the bulk of the data with 32-bit
+ * word transfers (LDM/STM bursts), and handles any unaligned bytes ('head'
+ * and 'tail') separately. If source and destination are misaligned relative
+ * to each other, it shifts and merges aligned words instead of falling back
+ * to byte copies.
  *
  * This is useful for the same reasons that "readl"/"writel" were introduced:
  * Byte-oriented transfers ("string" copy) might not give the expected results
- * when accessing hardware registers, like e.g. the (G)PIO config/state.
+ * when accessing hardware registers, like e.g. the (G)PIO config/state. For
+ * the same reason, the faster NEON path (64-bit accesses) is only allowed
+ * for copies within DRAM.
  *
- * We have two different low-level functions, where the copy operation moves
- * upwards or downwards respectively. This allows a non-destructive "memmove"
- * wrapper to select the suitable one in case of memory overlap.
+ * The engine can copy upwards or downwards, which allows a non-destructive
+ * "memmove" to select the suitable direction in case of memory overlap.
  */
+#define MEMMOVE_DOWN		0x01
+#define MEMMOVE_NEON		0x02
+#define MEMMOVE_DRAM_BASE	0x40000000
 
-static void fel_memcpy_up(feldev_handle *dev,
-			  uint32_t dst_addr, uint32_t src_addr, size_t size)
+void fel_memmove(feldev_handle *dev,
+		 uint32_t dst_addr, uint32_t src_addr, size_t size)
 {
-	if (size == 0) return;
+	uint32_t flags = 0;
+
+	if (size == 0)
+		return;
 	/*
-	 * copy "upwards", increasing destination and source addresses
+	 * To ensure non-destructive operation, we need to select "downwards"
+	 * copying if the destination overlaps the source region.
 	 */
-	uint32_t arm_code[] = {
-		htole32(0xe59f0054), /* ldr   r0, [pc, #84] ; ldr r0, [dst_addr] */
-		htole32(0xe59f1054), /* ldr   r1, [pc, #84] ; ldr r1, [src_addr] */
-		htole32(0xe59f2054), /* ldr   r2, [pc, #84] ; ldr r2, [size]     */
-		htole32(0xe0413000), /* sub   r3, r1, r0    ; r3 = r1 - r0       */
-		htole32(0xe3130003), /* tst   r3, #3        ; test lower bits    */
-		htole32(0x1a00000b), /* bne   copyup_tail   ; unaligned copying  */
-		/* copyup_head: */
-		htole32(0xe3110003), /* tst   r1, #3        ; word-aligned?      */
-		htole32(0x0a000004), /* beq   copyup_loop                        */
-		htole32(0xe4d13001), /* ldrb  r3, [r1], #1  ; load and post-inc  */
-		htole32(0xe4c03001), /* strb  r3, [r0], #1  ; store and post-inc */
-		htole32(0xe2522001), /* subs  r2, r2, #1    ; r2 -= 1            */
-		htole32(0x5afffff9), /* bpl   copyup_head   ; while (r2 >= 0)    */
-		htole32(0xe12fff1e), /* bx    lr            ; early return       */
-		/* copyup_loop: */
-		htole32(0xe2522004), /* subs  r2, r2, #4    ; r2 -= 4            */
-		htole32(0x54913004), /* ldrpl r3, [r1], #4  ; load and post-inc  */
-		htole32(0x54803004), /* strpl r3, [r0], #4  ; store and post-inc */
-		htole32(0x5afffffb), /* bpl   copyup_loop   ; while (r2 >= 0)    */
-		htole32(0xe2822004), /* add   r2, r2, #4    ; remaining bytes    */
-		/* copyup_tail: */
-		htole32(0xe2522001), /* subs  r2, r2, #1    ; r2 -= 1            */
-		htole32(0x412fff1e), /* bxmi  lr            ; return if (r2 < 0) */
-		htole32(0xe4d13001), /* ldrb  r3, [r1], #1  ; load and post-inc  */
-		htole32(0xe4c03001), /* strb  r3, [r0], #1  ; store and post-inc */
-		htole32(0xeafffffa), /* b     copyup_tail                        */
+	if (dst_addr >= src_addr && dst_addr < (src_addr + size))
+		flags |= MEMMOVE_DOWN;
+	if (dst_addr >= MEMMOVE_DRAM_BASE && src_addr >= MEMMOVE_DRAM_BASE)
+		flags |= MEMMOVE_NEON;
+	aw_fel_device_write(dev, dst_addr, size);
 
+	uint32_t arm_code[] = {
+		#include "thunks/memcpy.h"
 		htole32(dst_addr), /* destination address */
 		htole32(src_addr), /* source address */
 		htole32(size),     /* size (= byte count) */
+		htole32(flags),
 	};
 	aw_fel_write(dev, arm_code, dev->soc_info->scratch_addr, sizeof(arm_code));
 	aw_fel_execute(dev, dev->soc_info->scratch_addr);
 }
 
-static void fel_memcpy_down(feldev_handle *dev,
-			    uint32_t dst_addr, uint32_t src_addr, size_t size)
+/*
+ * Scatter/gather transfers
+ *
+ * Many small transfers to (or from) scattered addresses each pay the full
+ * FEL request/response cost. Instead, we pack the payloads into a contiguous
+ * staging area and let an ARM thunk distribute them on the device (scatter),
+ * or let it collect the regions into the staging area so that they can be
+ * fetched with a single read (gather). The thunk uses a table of (dst, src,
+ * len) triplets, placed right after the code in the scratch area. Regions
+ * with 32-bit aligned addresses and size get copied word by word, so this
+ * is suitable for MMIO registers too.
+ */
+#define SG_ARM_WORDS	18 /* word count of the scatter/gather thunk */
+#define SG_MAX_ENTRIES	((LCODE_MAX_TOTAL - SG_ARM_WORDS) / 3 - 1)
+#define SG_MIN_ENTRIES	4  /* below this, direct transfers are cheaper */
+
+
+/* test if two address ranges overlap */
+static bool sg_overlaps(uint32_t a, size_t a_len, uint32_t b, size_t b_len)
+{
+	return a_len > 0 && b_len > 0 && a < b + b_len && b < a + a_len;
+}
+
+/*
+ * Process a single batch of entries. All of them are known to fit into the
+ * staging area (with 32-bit aligned offsets) and the thunk table.
+ */
+static void fel_sg_batch(feldev_handle *dev, const fel_sg_entry *sg,
+			 size_t count, uint32_t staging, bool write)
 {
-	if (size == 0) return;
 	/*
-	 * This ARM code makes use of decreasing values in r2
-	 * for memory indexing relative to the base addresses in r0 and r1.
+	 * We need a fixed array size to allow for (partial) initialization,
+	 * so we'll claim the maximum total number of words (0x100) here.
 	 */
-	uint32_t arm_code[] = {
-		htole32(0xe59f0058), /* ldr   r0, [pc, #88] ; ldr r0, [dst_addr] */
-		htole32(0xe59f1058), /* ldr   r1, [pc, #88] ; ldr r1, [src_addr] */
-		htole32(0xe59f2058), /* ldr   r2, [pc, #88] ; ldr r2, [size]     */
-		htole32(0xe0403001), /* sub   r3, r0, r1    ; r3 = r0 - r1       */
-		htole32(0xe3130003), /* tst   r3, #3        ; test lower bits    */
-		htole32(0x1a00000c), /* bne   copydn_tail   ; unaligned copying  */
-		/* copydn_head: */
-		htole32(0xe0813002), /* add   r3, r1, r2    ; r3 = r1 + r2       */
-		htole32(0xe3130003), /* tst   r3, #3        ; word-aligned?      */
-		htole32(0x0a000004), /* beq   copydn_loop                        */
-		htole32(0xe2522001), /* subs  r2, r2, #1    ; r2 -= 1            */
-		htole32(0x412fff1e), /* bxmi  lr            ; early return       */
-		htole32(0xe7d13002), /* ldrb  r3, [r1, r2]  ; load byte          */
-		htole32(0xe7c03002), /* strb  r3, [r0, r2]  ; store byte         */
-		htole32(0xeafffff7), /* b     copydn_head                        */
-		/* copydn_loop: */
-		htole32(0xe2522004), /* subs  r2, r2, #4    ; r2 -= 4            */
-		htole32(0x57913002), /* ldrpl r3, [r1, r2]  ; load word          */
-		htole32(0x57803002), /* strpl r3, [r0, r2]  ; store word         */
-		htole32(0x5afffffb), /* bpl   copydn_loop   ; while (r2 >= 0)    */
-		htole32(0xe2822004), /* add   r2, r2, #4    ; remaining bytes    */
-		/* copydn_tail: */
-		htole32(0xe2522001), /* subs  r2, r2, #1    ; r2 -= 1            */
-		htole32(0x412fff1e), /* bxmi  lr            ; return if (r2 < 0) */
-		htole32(0xe7d13002), /* ldrb  r3, [r1, r2]  ; load byte          */
-		htole32(0xe7c03002), /* strb  r3, [r0, r2]  ; store byte         */
-		htole32(0xeafffffa), /* b     copydn_tail                        */
-
-		htole32(dst_addr), /* destination address */
-		htole32(src_addr), /* source address */
-		htole32(size),     /* size (= byte count) */
+	uint32_t arm_code[LCODE_MAX_TOTAL] = {
+		htole32(0xe28f0040), /*    0:  add   r0, pc, #64   ; adr r0, table  */
+		/* <sg_loop>: */
+		htole32(0xe8b0000e), /*    4:  ldm   r0!, {r1, r2, r3}              */
+		htole32(0xe3530000), /*    8:  cmp   r3, #0        ; end of table?  */
+		htole32(0x012fff1e), /*    c:  bxeq  lr                             */
+		htole32(0xe181c002), /*   10:  orr   ip, r1, r2                     */
+		htole32(0xe18cc003), /*   14:  orr   ip, ip, r3                     */
+		htole32(0xe31c0003), /*   18:  tst   ip, #3        ; all aligned?   */
+		htole32(0x1a000004), /*   1c:  bne   34 <sg_bytes>                  */
+		/* <sg_words>: */
+		htole32(0xe492c004), /*   20:  ldr   ip, [r2], #4                   */
+		htole32(0xe481c004), /*   24:  str   ip, [r1], #4                   */
+		htole32(0xe2533004), /*   28:  subs  r3, r3, #4                     */
+		htole32(0x1afffffb), /*   2c:  bne   20 <sg_words>                  */
+		htole32(0xeafffff3), /*   30:  b     4 <sg_loop>                    */
+		/* <sg_bytes>: */
+		htole32(0xe4d2c001), /*   34:  ldrb  ip, [r2], #1                   */
+		htole32(0xe4c1c001), /*   38:  strb  ip, [r1], #1                   */
+		htole32(0xe2533001), /*   3c:  subs  r3, r3, #1                     */
+		htole32(0x1afffffb), /*   40:  bne   34 <sg_bytes>                  */
+		htole32(0xeaffffee), /*   44:  b     4 <sg_loop>                    */
+		/* <table>: (dst, src, len) triplets follow, terminated by len = 0 */
 	};
-	aw_fel_write(dev, arm_code, dev->soc_info->scratch_addr, sizeof(arm_code));
-	aw_fel_execute(dev, dev->soc_info->scratch_addr);
+	uint32_t *table = arm_code + SG_ARM_WORDS;
+	size_t i, offset = 0;
+	uint8_t *buf;
+
+	for (i = 0; i < count; i++)
+		offset += (sg[i].len + 3) & ~3;
+	buf = calloc(1, offset);
+	if (!buf) {
+		fprintf(stderr, "FAILED to allocate scatter/gather buffer.\n");
+		exit(1);
+	}
+
+	for (i = 0, offset = 0; i < count; i++) {
+		if (write) {
+			memcpy(buf + offset, sg[i].buf, sg[i].len);
+			*table++ = htole32(sg[i].addr);
+			*table++ = htole32(staging + offset);
+		} else {
+			*table++ = htole32(staging + offset);
+			*table++ = htole32(sg[i].addr);
+		}
+		*table++ = htole32(sg[i].len);
+		offset += (sg[i].len + 3) & ~3;
+	}
+	*table++ = 0; *table++ = 0; *table++ = 0; /* terminator */
+
+	if (write)
+		for (i = 0; i < count; i++)
+			aw_fel_device_write(dev, sg[i].addr, sg[i].len);
+	aw_fel_write(dev, arm_code, dev->soc_info->scratch_addr,
+		     (table - arm_code) * sizeof(uint32_t));
+	if (write) {
+		aw_fel_write(dev, buf, staging, offset);
+		aw_fel_execute(dev, dev->soc_info->scratch_addr);
+	} else {
+		aw_fel_execute(dev, dev->soc_info->scratch_addr);
+		aw_fel_read(dev, staging, buf, offset);
+		for (i = 0, offset = 0; i < count; i++) {
+			memcpy(sg[i].buf, buf + offset, sg[i].len);
+			offset += (sg[i].len + 3) & ~3;
+		}
+	}
+	free(buf);
 }
 
-void fel_memmove(feldev_handle *dev,
-		 uint32_t dst_addr, uint32_t src_addr, size_t size)
+/* direct (one request per entry) transfer, used as fallback */
+static void fel_sg_direct(feldev_handle *dev, const fel_sg_entry *sg,
+			  bool write)
 {
-	/*
-	 * To ensure non-destructive operation, we need to select "downwards"
-	 * copying if the destination overlaps the source region.
-	 */
-	if (dst_addr >= src_addr && dst_addr < (src_addr + size))
-		fel_memcpy_down(dev, dst_addr, src_addr, size);
+	if (write)
+		aw_fel_write(dev, sg->buf, sg->addr, sg->len);
 	else
-		fel_memcpy_up(dev, dst_addr, src_addr, size);
+		aw_fel_read(dev, sg->addr, sg->buf, sg->len);
+}
+
+/*
+ * Entries overlapping the staging area or the thunk in the scratch area
+ * can't be part of a batch, and need special care regarding their order.
+ */
+static bool sg_reserved(feldev_handle *dev, const fel_sg_entry *sg,
+			uint32_t staging, size_t staging_size)
+{
+	return sg_overlaps(sg->addr, sg->len, staging, staging_size) ||
+	       sg_overlaps(sg->addr, sg->len, dev->soc_info->scratch_addr,
+			   LCODE_MAX_TOTAL * sizeof(uint32_t));
+}
+
+static bool sg_batchable(feldev_handle *dev, const fel_sg_entry *sg,
+			 uint32_t staging, size_t staging_size)
+{
+	return sg->len > 0 && sg->len <= staging_size / 2 &&
+	       !sg_reserved(dev, sg, staging, staging_size);
+}
+
+static void fel_scatter_gather(feldev_handle *dev, const fel_sg_entry *sg,
+			       size_t count, uint32_t staging,
+			       size_t staging_size, bool write)
+{
+	soc_info_t *soc_info = dev->soc_info;
+	void *backup = NULL;
+	size_t i, first = 0, used = 0, batched = 0;
+
+	/* Without an explicit staging area, borrow some SRAM */
+	bool borrowed = staging_size == 0;
+	if (borrowed) {
+		staging = soc_info->spl_addr;
+		staging_size = sram_staging_size(dev);
+	}
+
+	for (i = 0; i < count; i++)
+		if (sg_batchable(dev, sg + i, staging, staging_size))
+			batched++;
+	if (batched < SG_MIN_ENTRIES) {
+		for (i = 0; i < count; i++)
+			fel_sg_direct(dev, sg + i, write);
+		return;
+	}
+
+	/* reserved areas: read them before we clobber anything... */
+	if (!write)
+		for (i = 0; i < count; i++)
+			if (sg_reserved(dev, sg + i, staging, staging_size))
+				fel_sg_direct(dev, sg + i, write);
+
+	if (borrowed)
+		backup = sram_staging_backup(dev);
+
+	/* process the entries in batches, keeping their order */
+	for (i = 0; i <= count; i++) {
+		bool batchable = i < count &&
+			sg_batchable(dev, sg + i, staging, staging_size);
+		size_t need = batchable ? (sg[i].len + 3) & ~3 : 0;
+
+		if (!batchable || used + need > staging_size ||
+		    i - first >= SG_MAX_ENTRIES) {
+			if (i > first)
+				fel_sg_batch(dev, sg + first, i - first,
+					     staging, write);
+			first = i;
+			used = 0;
+		}
+		if (i == count)
+			break;
+		if (!batchable) {
+			if (!sg_reserved(dev, sg + i, staging, staging_size))
+				fel_sg_direct(dev, sg + i, write);
+			first = i + 1;
+			continue;
+		}
+		used += need;
+	}
+
+	if (backup)
+		sram_staging_restore(dev, backup);
+
+	/* ...and write them when we're done with the staging area */
+	if (write)
+		for (i = 0; i < count; i++)
+			if (sg_reserved(dev, sg + i, staging, staging_size))
+				fel_sg_direct(dev, sg + i, write);
+}
+
+/**
+ * fel_scatter_write() - Write multiple memory regions with few FEL requests.
+ * @dev: device handle for the FEL device
+ * @sg: array of regions (device address, source buffer, byte count)
+ * @count: number of entries in @sg
+ * @staging: device address of a free staging area
+ * @staging_size: size of the staging area, 0 to use a (backed up) SRAM area
+ *
+ * The entries are written in the given order. Entries that are too large
+ * for the staging area get transferred with individual requests.
+ */
+void fel_scatter_write(feldev_handle *dev, const fel_sg_entry *sg,
+		       size_t count, uint32_t staging, size_t staging_size)
+{
+	fel_scatter_gather(dev, sg, count, staging, staging_size, true);
+}
+
+/**
+ * fel_gather_read() - Read multiple memory regions with few FEL requests.
+ * @dev: device handle for the FEL device
+ * @sg: array of regions (device address, destination buffer, byte count)
+ * @count: number of entries in @sg
+ * @staging: device address of a free staging area
+ * @staging_size: size of the staging area, 0 to use a (backed up) SRAM area
+ */
+void fel_gather_read(feldev_handle *dev, const fel_sg_entry *sg,
+		     size_t count, uint32_t staging, size_t staging_size)
+{
+	fel_scatter_gather(dev, sg, count, staging, staging_size, false);
 }
 
 /*
@@ -548,6 +986,9 @@ void fel_clrsetbits_le32(feldev_handle *dev,
  * SoCs. This function uses an alternative, register-based approach to retrieve
  * the values.
  */
+#define SID_ARM_WORDS	22 /* word count of the SID register read code */
+#define SID_MAX_LENGTH	((LCODE_MAX_TOTAL - SID_ARM_WORDS) * sizeof(uint32_t))
+
 static void fel_get_sid_registers(feldev_handle *dev, uint32_t *result,
 				   uint32_t offset, uint32_t length)
 {
@@ -582,6 +1023,7 @@ static void fel_get_sid_registers(feldev_handle *dev, uint32_t *result,
 		htole32(offset + length),	/* where to stop to read */
 		/* retrieved SID values go here */
 	};
+	assert(sizeof(arm_code) == SID_ARM_WORDS * sizeof(uint32_t));
 	/* write and execute code */
 	aw_fel_write(dev, arm_code, dev->soc_info->scratch_addr, sizeof(arm_code));
 	aw_fel_execute(dev, dev->soc_info->scratch_addr);
@@ -603,6 +1045,8 @@ static void fel_get_sid_registers(feldev_handle *dev, uint32_t *result,
  * Read the contents of the non-volatile eFuses stored in the SoC. The size
  * and supposed usage layout differs between SoCs, but the "root" key
  * (containing some unique serial number) is always in the first 128 bits.
+ * Areas up to 936 bytes (which covers all known SID layouts) get read in a
+ * single pass on the device, and fetched with a single read request.
  *
  * Return: 0 if the operation was successful, a negative error code otherwise.
  */
@@ -617,10 +1061,17 @@ int fel_read_sid(feldev_handle *dev, uint32_t *result,
 	if ((offset & 3) || (length & 3))	/* needs to be 32-bit aligned */
 		return -3;
 
-	if (soc->sid_fix || force_workaround)
+	if (soc->sid_fix || force_workaround) {
 		/* Work around SID issues by using ARM thunk code */
-		fel_get_sid_registers(dev, result, offset, length);
-	else
+		while (length > 0) {
+			unsigned int n = length > SID_MAX_LENGTH ?
+					 SID_MAX_LENGTH : length;
+			fel_get_sid_registers(dev, result, offset, n);
+			result += n / 4;
+			offset += n;
+			length -= n;
+		}
+	} else
 		/* Read SID directly from memory */
 		fel_readl_n(dev, soc->sid_base + soc->sid_offset + offset,
 			    result, length / 4);
@@ -778,6 +1229,12 @@ feldev_handle *feldev_open(int busnum, int devnum,
 	get_soc_name_from_id(result->soc_name, result->soc_version.soc_id);
 	result->soc_info = get_soc_info_from_version(&result->soc_version);
 
+	if (!exit_flushing_registered) {
+		atexit(aw_fel_flush_at_exit);
+		exit_flushing_registered = true;
+	}
+	exit_flush_dev = result;
+
 	return result;
 }
 
@@ -785,7 +1242,10 @@ feldev_handle *feldev_open(int busnum, int devnum,
 void feldev_close(feldev_handle *dev)
 {
 	if (dev) {
+		if (dev == exit_flush_dev)
+			exit_flush_dev = NULL;
 		if (dev->usb->handle) {
+			aw_fel_flush(dev);
 			feldev_release(dev);
 			libusb_close(dev->usb->handle);
 		}
@@ -34,6 +34,7 @@ typedef struct {
 	struct aw_fel_version soc_version;
 	soc_name_t soc_name;
 	soc_info_t *soc_info;
+	uint32_t mmu_tt_addr;	/* translation table set up for --mmu, or 0 */
 } feldev_handle;
 
 /* list_fel_devices() will return an array of this type */
@@ -62,14 +63,37 @@ void aw_fel_read(feldev_handle *dev, uint32_t offset, void *buf, size_t len);
 void aw_fel_write(feldev_handle *dev, const void *buf, uint32_t offset, size_t len);
 void aw_fel_write_buffer(feldev_handle *dev, const void *buf, uint32_t offset,
 			 size_t len, bool progress);
+void aw_fel_flush(feldev_handle *dev);
+/* write guard slots, see aw_fel_set_write_guard() */
+#define AW_FEL_GUARD_MMU	0	/* active MMU translation table */
+#define AW_FEL_GUARD_REMOTEFUNC	1	/* loaded remote functions */
+#define AW_FEL_GUARDS		2
+void aw_fel_set_write_guard(feldev_handle *dev, unsigned int slot,
+			    uint32_t addr, uint32_t size,
+			    void (*callback)(feldev_handle *dev));
+void aw_fel_device_write(feldev_handle *dev, uint32_t offset, size_t len);
 void aw_fel_execute(feldev_handle *dev, uint32_t offset);
 
 void fel_readl_n(feldev_handle *dev, uint32_t addr, uint32_t *dst, size_t count);
+void fel_readl_bulk(feldev_handle *dev, uint32_t addr, uint32_t *dst,
+		    size_t count);
 void fel_writel_n(feldev_handle *dev, uint32_t addr, uint32_t *src, size_t count);
 
 void fel_memmove(feldev_handle *dev,
 		 uint32_t dst_addr, uint32_t src_addr, size_t size);
 
+/* a memory region for fel_scatter_write() / fel_gather_read() */
+typedef struct {
+	uint32_t addr;	/* device address */
+	void *buf;	/* host buffer */
+	size_t len;	/* byte count */
+} fel_sg_entry;
+
+void fel_scatter_write(feldev_handle *dev, const fel_sg_entry *sg,
+		       size_t count, uint32_t staging, size_t staging_size);
+void fel_gather_read(feldev_handle *dev, const fel_sg_entry *sg,
+		     size_t count, uint32_t staging, size_t staging_size);
+
 void fel_clrsetbits_le32(feldev_handle *dev,
 			 uint32_t addr, uint32_t clrbits, uint32_t setbits);
 #define fel_clrbits_le32(dev, addr, value) \
@@ -88,5 +112,23 @@ bool aw_fel_remotefunc_prepare(feldev_handle *dev,
 			       size_t                num_args,
 			       uint32_t             *args);
 bool aw_fel_remotefunc_execute(feldev_handle *dev, uint32_t *result);
+int aw_fel_remotefunc_load(feldev_handle *dev,
+			   size_t                stack_size,
+			   const void           *arm_code,
+			   size_t                arm_code_size,
+			   size_t                num_args);
+bool aw_fel_remotefunc_call(feldev_handle *dev, int handle,
+			    const uint32_t *args, uint32_t *result);
+void aw_fel_remotefunc_area(feldev_handle *dev, uint32_t addr, uint32_t size);
+void aw_fel_remotefunc_unload_all(feldev_handle *dev);
+bool aw_fel_remotefunc_profiling(feldev_handle *dev, bool enable);
+bool aw_fel_remotefunc_cycles(feldev_handle *dev, uint32_t *cycles);
+
+uint32_t aw_read_arm_cp_reg(feldev_handle *dev, soc_info_t *soc_info,
+			    uint32_t coproc, uint32_t opc1, uint32_t crn,
+			    uint32_t crm, uint32_t opc2);
+void aw_write_arm_cp_reg(feldev_handle *dev, soc_info_t *soc_info,
+			 uint32_t coproc, uint32_t opc1, uint32_t crn,
+			 uint32_t crm, uint32_t opc2, uint32_t val);
 
 #endif /* _SUNXI_TOOLS_FEL_LIB_H */
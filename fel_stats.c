@@ -0,0 +1,511 @@
+/*
+ * Copyright (C) 2026  sunxi-tools developers
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**********************************************************************
+ * FEL transfer metrics and JSON report ("--stats FILE"), boot timeline
+ * as text and Chrome trace JSON ("--timeline FILE")
+ **********************************************************************/
+#include "fel_stats.h"
+#include "progress.h"
+#include "version.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Latency histograms use log2 buckets of microseconds: bucket 0 counts
+ * everything below 1 us, bucket n the range [2^(n-1), 2^n) us. The last
+ * bucket collects everything above.
+ */
+#define STATS_BUCKETS	28
+/* maximum nesting of timeline phases, deeper ones are not recorded */
+#define STATS_PHASE_DEPTH	8
+
+typedef struct {
+	uint64_t count;
+	uint64_t bytes;
+	double time;		/* total, in seconds */
+	double min, max;
+	uint64_t cycles;	/* device CPU cycles (profiled remote functions) */
+	uint64_t histogram[STATS_BUCKETS];
+} stats_entry_t;
+
+typedef struct {
+	char name[32];
+	double start, end;
+	stats_entry_t entry[FEL_STAT_COUNT];
+} stats_command_t;
+
+/* USB traffic, for the timeline */
+typedef struct {
+	uint64_t bytes_out;
+	uint64_t bytes_in;
+	uint64_t transfers;	/* FEL request, data and status transfers */
+} stats_counters_t;
+
+typedef struct {
+	char name[32];
+	unsigned int depth;
+	double start, end;
+	stats_counters_t count;	/* running totals at the start, then deltas */
+} stats_phase_t;
+
+static const char * const stats_names[FEL_STAT_COUNT] = {
+	[FEL_STAT_REQUEST]	= "request",
+	[FEL_STAT_WRITE]	= "data_write",
+	[FEL_STAT_READ]		= "data_read",
+	[FEL_STAT_STATUS]	= "status",
+	[FEL_STAT_EXECUTE]	= "execute",
+	[FEL_STAT_THUNK]	= "thunk_upload",
+	[FEL_STAT_SLEEP]	= "sleep",
+	[FEL_STAT_FILE_READ]	= "file_read",
+	[FEL_STAT_FILE_WRITE]	= "file_write",
+	[FEL_STAT_REMOTEFUNC]	= "remotefunc",
+};
+
+bool fel_stats_enabled = false;
+
+static struct {
+	pthread_mutex_t lock;
+	char *filename;
+	char soc_name[16];
+	uint32_t soc_id;
+	double start;
+	stats_command_t *commands;
+	size_t count;		/* number of commands */
+	bool written;
+	char *timeline;		/* timeline output file, or NULL */
+	stats_phase_t *phases;
+	size_t phase_count;
+	size_t open_phase[STATS_PHASE_DEPTH];
+	unsigned int depth;	/* of currently open phases */
+	stats_counters_t total;
+} stats = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+double fel_stats_time(void)
+{
+	return fel_stats_enabled ? gettime() : 0.;
+}
+
+static void stats_atexit(void)
+{
+	fel_stats_write();
+}
+
+static void stats_enable(void)
+{
+	if (fel_stats_enabled)
+		return;
+	stats.start = gettime();
+	fel_stats_enabled = true;
+	fel_stats_command("setup"); /* device detection and initialization */
+	atexit(stats_atexit);
+}
+
+/* enable statistics, the report gets written to 'filename' on exit */
+void fel_stats_open(const char *filename)
+{
+	stats.filename = strdup(filename);
+	stats_enable();
+}
+
+/* enable statistics, the timeline gets written to 'filename' on exit */
+void fel_stats_timeline_open(const char *filename)
+{
+	stats.timeline = strdup(filename);
+	stats_enable();
+}
+
+void fel_stats_set_device(const char *soc_name, uint32_t soc_id)
+{
+	snprintf(stats.soc_name, sizeof(stats.soc_name), "%s", soc_name);
+	stats.soc_id = soc_id;
+}
+
+/* start a new section of the report, accounting for the given command */
+void fel_stats_command(const char *name)
+{
+	stats_command_t *cmd;
+
+	if (!fel_stats_enabled)
+		return;
+	pthread_mutex_lock(&stats.lock);
+	double now = gettime();
+	if (stats.count > 0)
+		stats.commands[stats.count - 1].end = now;
+	cmd = realloc(stats.commands, (stats.count + 1) * sizeof(*cmd));
+	if (!cmd) {
+		perror("Failed to allocate statistics memory");
+		exit(1);
+	}
+	stats.commands = cmd;
+	cmd += stats.count++;
+	memset(cmd, 0, sizeof(*cmd));
+	snprintf(cmd->name, sizeof(cmd->name), "%s", name);
+	cmd->start = now;
+	pthread_mutex_unlock(&stats.lock);
+}
+
+static unsigned int stats_bucket(double seconds)
+{
+	uint64_t usec = seconds * 1e6;
+	unsigned int bucket = 0;
+
+	while (usec > 0 && bucket < STATS_BUCKETS - 1) {
+		usec >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+void fel_stats_add(fel_stat_t kind, size_t bytes, double seconds)
+{
+	stats_entry_t *entry;
+
+	if (!fel_stats_enabled || stats.count == 0)
+		return;
+	if (seconds < 0.)
+		seconds = 0.;
+	pthread_mutex_lock(&stats.lock);
+	entry = &stats.commands[stats.count - 1].entry[kind];
+	if (entry->count == 0 || seconds < entry->min)
+		entry->min = seconds;
+	if (seconds > entry->max)
+		entry->max = seconds;
+	entry->count++;
+	entry->bytes += bytes;
+	entry->time += seconds;
+	entry->histogram[stats_bucket(seconds)]++;
+	switch (kind) {
+	case FEL_STAT_WRITE:
+		stats.total.bytes_out += bytes;
+		stats.total.transfers++;
+		break;
+	case FEL_STAT_READ:
+		stats.total.bytes_in += bytes;
+		stats.total.transfers++;
+		break;
+	case FEL_STAT_REQUEST:
+	case FEL_STAT_STATUS:
+		stats.total.transfers++;
+		break;
+	default:
+		break;
+	}
+	pthread_mutex_unlock(&stats.lock);
+}
+
+void fel_stats_phase_begin(const char *name)
+{
+	stats_phase_t *phase;
+
+	if (!fel_stats_enabled)
+		return;
+	pthread_mutex_lock(&stats.lock);
+	if (stats.depth < STATS_PHASE_DEPTH) {
+		phase = realloc(stats.phases,
+				(stats.phase_count + 1) * sizeof(*phase));
+		if (!phase) {
+			perror("Failed to allocate statistics memory");
+			exit(1);
+		}
+		stats.phases = phase;
+		phase += stats.phase_count;
+		memset(phase, 0, sizeof(*phase));
+		snprintf(phase->name, sizeof(phase->name), "%s", name);
+		phase->depth = stats.depth;
+		phase->start = gettime();
+		phase->count = stats.total;
+		stats.open_phase[stats.depth] = stats.phase_count++;
+	}
+	stats.depth++;
+	pthread_mutex_unlock(&stats.lock);
+}
+
+static void stats_phase_close(stats_phase_t *phase, double now)
+{
+	phase->end = now;
+	phase->count.bytes_out = stats.total.bytes_out - phase->count.bytes_out;
+	phase->count.bytes_in = stats.total.bytes_in - phase->count.bytes_in;
+	phase->count.transfers = stats.total.transfers - phase->count.transfers;
+}
+
+void fel_stats_phase_end(void)
+{
+	if (!fel_stats_enabled || stats.depth == 0)
+		return;
+	pthread_mutex_lock(&stats.lock);
+	if (--stats.depth < STATS_PHASE_DEPTH)
+		stats_phase_close(&stats.phases[stats.open_phase[stats.depth]],
+				  gettime());
+	pthread_mutex_unlock(&stats.lock);
+}
+
+/* account device-side cycles to the last entry of the given kind */
+void fel_stats_cycles(fel_stat_t kind, uint64_t cycles)
+{
+	if (!fel_stats_enabled || stats.count == 0)
+		return;
+	pthread_mutex_lock(&stats.lock);
+	stats.commands[stats.count - 1].entry[kind].cycles += cycles;
+	pthread_mutex_unlock(&stats.lock);
+}
+
+static void stats_add_entry(stats_entry_t *sum, const stats_entry_t *entry)
+{
+	unsigned int i;
+
+	if (entry->count == 0)
+		return;
+	if (sum->count == 0 || entry->min < sum->min)
+		sum->min = entry->min;
+	if (entry->max > sum->max)
+		sum->max = entry->max;
+	sum->count += entry->count;
+	sum->bytes += entry->bytes;
+	sum->time += entry->time;
+	sum->cycles += entry->cycles;
+	for (i = 0; i < STATS_BUCKETS; i++)
+		sum->histogram[i] += entry->histogram[i];
+}
+
+static void stats_write_json_string(FILE *out, const char *str)
+{
+	fputc('"', out);
+	for (; *str; str++) {
+		if (*str == '"' || *str == '\\')
+			fprintf(out, "\\%c", *str);
+		else if ((unsigned char)*str < 0x20)
+			fprintf(out, "\\u%04x", *str);
+		else
+			fputc(*str, out);
+	}
+	fputc('"', out);
+}
+
+static void stats_write_entries(FILE *out, const stats_entry_t *entries,
+				const char *indent)
+{
+	unsigned int i, k, last;
+	bool first = true;
+
+	fprintf(out, "{");
+	for (i = 0; i < FEL_STAT_COUNT; i++) {
+		const stats_entry_t *e = &entries[i];
+		if (e->count == 0)
+			continue;
+		fprintf(out, "%s\n%s  \"%s\": {\"count\": %llu, \"bytes\": %llu, "
+			"\"time\": %.6f, \"min\": %.6f, \"avg\": %.6f, \"max\": %.6f",
+			first ? "" : ",", indent, stats_names[i],
+			(unsigned long long)e->count,
+			(unsigned long long)e->bytes, e->time, e->min,
+			e->time / e->count, e->max);
+		if (e->bytes > 0 && e->time > 0.)
+			fprintf(out, ", \"kb_per_sec\": %.1f",
+				e->bytes / e->time / 1000.);
+		if (e->cycles > 0)
+			fprintf(out, ", \"device_cycles\": %llu",
+				(unsigned long long)e->cycles);
+		/* histogram, trimmed after the last non-empty bucket */
+		for (last = 0, k = 0; k < STATS_BUCKETS; k++)
+			if (e->histogram[k])
+				last = k;
+		fprintf(out, ", \"histogram_log2_us\": [");
+		for (k = 0; k <= last; k++)
+			fprintf(out, "%s%llu", k ? ", " : "",
+				(unsigned long long)e->histogram[k]);
+		fprintf(out, "]}");
+		first = false;
+	}
+	fprintf(out, "%s}", first ? "" : "\n");
+}
+
+static void stats_write_report(double now)
+{
+	stats_entry_t totals[FEL_STAT_COUNT];
+	FILE *out;
+	size_t i;
+	unsigned int k;
+
+	out = strcmp(stats.filename, "-") == 0 ? stdout
+					       : fopen(stats.filename, "w");
+	if (!out) {
+		perror("Failed to open statistics file");
+		return;
+	}
+
+	memset(totals, 0, sizeof(totals));
+	fprintf(out, "{\n  \"version\": ");
+	stats_write_json_string(out, VERSION);
+	fprintf(out, ",\n  \"soc\": ");
+	stats_write_json_string(out, stats.soc_name);
+	fprintf(out, ",\n  \"soc_id\": \"0x%04x\",\n", stats.soc_id);
+	fprintf(out, "  \"wall_time\": %.6f,\n", now - stats.start);
+	fprintf(out, "  \"histogram_buckets\": \"[0] < 1us, [n] < 2^n us\",\n");
+	fprintf(out, "  \"commands\": [");
+	for (i = 0; i < stats.count; i++) {
+		stats_command_t *cmd = &stats.commands[i];
+		fprintf(out, "%s\n    {\"command\": ", i ? "," : "");
+		stats_write_json_string(out, cmd->name);
+		fprintf(out, ", \"wall_time\": %.6f,\n     \"metrics\": ",
+			cmd->end - cmd->start);
+		stats_write_entries(out, cmd->entry, "     ");
+		fprintf(out, "}");
+		for (k = 0; k < FEL_STAT_COUNT; k++)
+			stats_add_entry(&totals[k], &cmd->entry[k]);
+	}
+	fprintf(out, "\n  ],\n  \"totals\": ");
+	stats_write_entries(out, totals, "  ");
+	fprintf(out, "\n}\n");
+
+	if (out != stdout)
+		fclose(out);
+	else
+		fflush(out);
+}
+
+static void stats_command_counters(const stats_command_t *cmd,
+				   stats_counters_t *count)
+{
+	const stats_entry_t *e = cmd->entry;
+
+	count->bytes_out = e[FEL_STAT_WRITE].bytes;
+	count->bytes_in = e[FEL_STAT_READ].bytes;
+	count->transfers = e[FEL_STAT_REQUEST].count + e[FEL_STAT_WRITE].count +
+			   e[FEL_STAT_READ].count + e[FEL_STAT_STATUS].count;
+}
+
+/* "complete" event of the Chrome trace event format, times in us */
+static void stats_write_trace_event(FILE *out, const char *name,
+				    const char *category, unsigned int tid,
+				    double start, double end,
+				    const stats_counters_t *count)
+{
+	fprintf(out, ",\n  {\"name\": ");
+	stats_write_json_string(out, name);
+	fprintf(out, ", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": 1, "
+		"\"tid\": %u, \"ts\": %.3f, \"dur\": %.3f,\n   \"args\": "
+		"{\"bytes_out\": %llu, \"bytes_in\": %llu, "
+		"\"usb_transfers\": %llu}}", category, tid,
+		(start - stats.start) * 1e6, (end - start) * 1e6,
+		(unsigned long long)count->bytes_out,
+		(unsigned long long)count->bytes_in,
+		(unsigned long long)count->transfers);
+}
+
+static void stats_write_timeline_line(FILE *out, const char *name,
+				      unsigned int indent, double start,
+				      double end, const stats_counters_t *count)
+{
+	fprintf(out, "%10.3f %10.3f %10llu %10llu %6llu  %*s%s\n",
+		(start - stats.start) * 1e3, (end - start) * 1e3,
+		(unsigned long long)count->bytes_out,
+		(unsigned long long)count->bytes_in,
+		(unsigned long long)count->transfers, indent * 2, "", name);
+}
+
+/*
+ * The timeline goes to 'stats.timeline' as Chrome trace JSON (for
+ * chrome://tracing or Perfetto), with commands and phases on separate
+ * tracks, and as text to stderr, with phases indented below commands.
+ */
+static void stats_write_timeline(void)
+{
+	stats_counters_t count;
+	FILE *out;
+	size_t i, k;
+
+	out = strcmp(stats.timeline, "-") == 0 ? stdout
+					       : fopen(stats.timeline, "w");
+	if (!out) {
+		perror("Failed to open timeline file");
+		return;
+	}
+	fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n"
+		"  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, "
+		"\"args\": {\"name\": ");
+	stats_write_json_string(out, *stats.soc_name ? stats.soc_name
+						     : "sunxi-fel");
+	fprintf(out, "}},\n  {\"name\": \"thread_name\", \"ph\": \"M\", "
+		"\"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"commands\"}},"
+		"\n  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+		"\"tid\": 2, \"args\": {\"name\": \"phases\"}}");
+	for (i = 0; i < stats.count; i++) {
+		stats_command_counters(&stats.commands[i], &count);
+		stats_write_trace_event(out, stats.commands[i].name, "command",
+					1, stats.commands[i].start,
+					stats.commands[i].end, &count);
+	}
+	for (i = 0; i < stats.phase_count; i++)
+		stats_write_trace_event(out, stats.phases[i].name, "phase", 2,
+					stats.phases[i].start,
+					stats.phases[i].end,
+					&stats.phases[i].count);
+	fprintf(out, "\n]}\n");
+	if (out != stdout)
+		fclose(out);
+	else
+		fflush(out);
+
+	/* both lists are in order of their start times */
+	fprintf(stderr, "  start/ms    time/ms  bytes out   bytes in  xfers  "
+		"command / phase\n");
+	for (i = 0, k = 0; i < stats.count || k < stats.phase_count; ) {
+		if (k == stats.phase_count || (i < stats.count &&
+		    stats.commands[i].start <= stats.phases[k].start)) {
+			stats_command_counters(&stats.commands[i], &count);
+			stats_write_timeline_line(stderr,
+				stats.commands[i].name, 0,
+				stats.commands[i].start,
+				stats.commands[i].end, &count);
+			i++;
+		} else {
+			stats_write_timeline_line(stderr, stats.phases[k].name,
+				stats.phases[k].depth + 1,
+				stats.phases[k].start, stats.phases[k].end,
+				&stats.phases[k].count);
+			k++;
+		}
+	}
+}
+
+/* write the JSON report and/or timeline (once), called automatically on exit */
+void fel_stats_write(void)
+{
+	if (!fel_stats_enabled || stats.written)
+		return;
+	pthread_mutex_lock(&stats.lock);
+	stats.written = true;
+	double now = gettime();
+	if (stats.count > 0)
+		stats.commands[stats.count - 1].end = now;
+	/* phases left open, e.g. by an error exit */
+	for (; stats.depth > 0; stats.depth--)
+		if (stats.depth <= STATS_PHASE_DEPTH)
+			stats_phase_close(&stats.phases[
+				stats.open_phase[stats.depth - 1]], now);
+
+	if (stats.filename)
+		stats_write_report(now);
+	if (stats.timeline)
+		stats_write_timeline();
+	pthread_mutex_unlock(&stats.lock);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026  sunxi-tools developers
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _SUNXI_TOOLS_FEL_STATS_H
+#define _SUNXI_TOOLS_FEL_STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Transfer metrics, collected per command and written as a JSON report
+ * ("--stats FILE"), or as a timeline of commands and their phases
+ * ("--timeline FILE"). Collection is disabled (and costs next to nothing)
+ * unless fel_stats_open() or fel_stats_timeline_open() was called.
+ */
+typedef enum {
+	FEL_STAT_REQUEST,	/* FEL request phase (command block) */
+	FEL_STAT_WRITE,		/* data phase, host to device */
+	FEL_STAT_READ,		/* data phase, device to host */
+	FEL_STAT_STATUS,	/* FEL status (response) phase */
+	FEL_STAT_EXECUTE,	/* complete aw_fel_execute() calls */
+	FEL_STAT_THUNK,		/* uploads of ARM code to scratch/thunk area */
+	FEL_STAT_SLEEP,		/* delays while waiting for the device */
+	FEL_STAT_FILE_READ,	/* host file input */
+	FEL_STAT_FILE_WRITE,	/* host file output */
+	FEL_STAT_REMOTEFUNC,	/* remote function calls (execute and result) */
+	FEL_STAT_COUNT
+} fel_stat_t;
+
+extern bool fel_stats_enabled;
+
+void fel_stats_open(const char *filename);
+void fel_stats_timeline_open(const char *filename);
+void fel_stats_set_device(const char *soc_name, uint32_t soc_id);
+void fel_stats_command(const char *name);
+void fel_stats_add(fel_stat_t kind, size_t bytes, double seconds);
+void fel_stats_cycles(fel_stat_t kind, uint64_t cycles);
+void fel_stats_write(void);
+
+/*
+ * Named phases within a command (e.g. the steps of the "spl" flow), for
+ * the timeline. Phases may nest; every fel_stats_phase_begin() needs a
+ * matching fel_stats_phase_end().
+ */
+void fel_stats_phase_begin(const char *name);
+void fel_stats_phase_end(void);
+
+/* timestamp for measurements, only taken if statistics are enabled */
+double fel_stats_time(void);
+
+/* record the time elapsed since 'start' (from fel_stats_time) */
+static inline void fel_stats_since(fel_stat_t kind, size_t bytes, double start)
+{
+	if (fel_stats_enabled)
+		fel_stats_add(kind, bytes, fel_stats_time() - start);
+}
+
+#endif /* _SUNXI_TOOLS_FEL_STATS_H */
@@ -0,0 +1,318 @@
+/*
+ * Copyright (C) 2026  sunxi-tools developers
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**********************************************************************
+ * Streaming decompression of FIT sub-images into an upload pipeline
+ **********************************************************************/
+#include "fit_decompress.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zlib.h>
+#ifdef HAVE_LIBLZMA
+#include <lzma.h>
+#endif
+#ifdef HAVE_LIBLZ4
+#include <lz4frame.h>
+#endif
+#ifdef HAVE_LIBZSTD
+#include <zstd.h>
+#endif
+
+struct fit_decompress {
+	fit_compression_t comp;
+	const uint8_t *in;
+	size_t in_size;
+	uint32_t addr;
+	bqueue_t *queue;
+	upload_chunk_t *chunk;	/* output chunk being filled */
+	size_t total;		/* output bytes so far */
+	size_t in_done;		/* input bytes consumed so far */
+	size_t in_reported;	/* ... and accounted as progress */
+	const char *error;
+	pipeline_thread_t *thread;
+};
+
+static const char * const compression_names[] = {
+	[FIT_COMP_NONE] = "none",
+	[FIT_COMP_GZIP] = "gzip",
+	[FIT_COMP_LZMA] = "lzma",
+	[FIT_COMP_LZ4]  = "lz4",
+	[FIT_COMP_ZSTD] = "zstd",
+};
+
+fit_compression_t fit_parse_compression(const char *name)
+{
+	fit_compression_t comp;
+
+	if (!name)
+		return FIT_COMP_NONE;
+	for (comp = FIT_COMP_NONE; comp < FIT_COMP_UNKNOWN; comp++)
+		if (!strcmp(name, compression_names[comp]))
+			return comp;
+	return FIT_COMP_UNKNOWN;
+}
+
+bool fit_compression_supported(fit_compression_t comp)
+{
+	switch (comp) {
+	case FIT_COMP_NONE:
+	case FIT_COMP_GZIP:
+		return true;
+#ifdef HAVE_LIBLZMA
+	case FIT_COMP_LZMA:
+		return true;
+#endif
+#ifdef HAVE_LIBLZ4
+	case FIT_COMP_LZ4:
+		return true;
+#endif
+#ifdef HAVE_LIBZSTD
+	case FIT_COMP_ZSTD:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+/*
+ * Output buffer handling for the decoders: they write straight into the
+ * free space of the current chunk, which gets passed on once it is full.
+ * The 'progress' of a chunk is the amount of input consumed for it, so the
+ * progress display can work with the (known) compressed sizes.
+ */
+static void out_push(fit_decompress_t *job)
+{
+	job->chunk->progress = job->in_done - job->in_reported;
+	job->in_reported = job->in_done;
+	bqueue_push(job->queue, job->chunk);
+	job->chunk = NULL;
+}
+
+static uint8_t *out_space(fit_decompress_t *job, size_t *avail)
+{
+	upload_chunk_t *chunk;
+
+	if (job->chunk && job->chunk->size == PIPELINE_CHUNK_SIZE)
+		out_push(job);
+	chunk = job->chunk;
+	if (!chunk) {
+		chunk = upload_chunk_new(PIPELINE_CHUNK_SIZE);
+		chunk->addr = job->addr + job->total;
+		chunk->size = 0;
+		job->chunk = chunk;
+	}
+	*avail = PIPELINE_CHUNK_SIZE - chunk->size;
+	return chunk->data + chunk->size;
+}
+
+static void out_commit(fit_decompress_t *job, size_t count, size_t in_pos)
+{
+	job->chunk->size += count;
+	job->total += count;
+	job->chunk->total = job->total;
+	job->in_done = in_pos;
+}
+
+static const char *decode_gzip(fit_decompress_t *job)
+{
+	z_stream zs;
+	const char *error = NULL;
+	int ret;
+
+	memset(&zs, 0, sizeof(zs));
+	/* accept both gzip and zlib headers */
+	if (inflateInit2(&zs, 15 + 32) != Z_OK)
+		return "failed to initialize zlib";
+	zs.next_in = (Bytef *)job->in;
+	zs.avail_in = job->in_size;
+	do {
+		size_t avail;
+		zs.next_out = out_space(job, &avail);
+		zs.avail_out = avail;
+		ret = inflate(&zs, Z_NO_FLUSH);
+		out_commit(job, avail - zs.avail_out,
+			   job->in_size - zs.avail_in);
+		if (ret == Z_BUF_ERROR && zs.avail_in == 0)
+			error = "truncated gzip data";
+		else if (ret != Z_OK && ret != Z_STREAM_END)
+			error = zs.msg ? zs.msg : "corrupt gzip data";
+	} while (!error && ret != Z_STREAM_END);
+	inflateEnd(&zs);
+	return error;
+}
+
+#ifdef HAVE_LIBLZMA
+static const char *decode_lzma(fit_decompress_t *job)
+{
+	lzma_stream ls = LZMA_STREAM_INIT;
+	const char *error = NULL;
+	lzma_ret ret;
+
+	/* U-Boot uses the legacy .lzma ("LZMA_Alone") format */
+	if (lzma_alone_decoder(&ls, UINT64_MAX) != LZMA_OK)
+		return "failed to initialize liblzma";
+	ls.next_in = job->in;
+	ls.avail_in = job->in_size;
+	do {
+		size_t avail;
+		ls.next_out = out_space(job, &avail);
+		ls.avail_out = avail;
+		ret = lzma_code(&ls, LZMA_FINISH);
+		out_commit(job, avail - ls.avail_out,
+			   job->in_size - ls.avail_in);
+		if (ret == LZMA_BUF_ERROR)
+			error = "truncated lzma data";
+		else if (ret != LZMA_OK && ret != LZMA_STREAM_END)
+			error = "corrupt lzma data";
+	} while (!error && ret != LZMA_STREAM_END);
+	lzma_end(&ls);
+	return error;
+}
+#endif
+
+#ifdef HAVE_LIBLZ4
+static const char *decode_lz4(fit_decompress_t *job)
+{
+	LZ4F_dctx *dctx;
+	const char *error = NULL;
+	size_t pos = 0, ret;
+
+	if (LZ4F_isError(LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION)))
+		return "failed to initialize liblz4";
+	do {
+		size_t avail, in_len = job->in_size - pos;
+		uint8_t *out = out_space(job, &avail);
+		ret = LZ4F_decompress(dctx, out, &avail, job->in + pos,
+				      &in_len, NULL);
+		if (LZ4F_isError(ret)) {
+			error = LZ4F_getErrorName(ret);
+			break;
+		}
+		pos += in_len;
+		out_commit(job, avail, pos);
+		if (ret != 0 && pos == job->in_size && avail == 0)
+			error = "truncated lz4 data";
+	} while (!error && ret != 0);
+	LZ4F_freeDecompressionContext(dctx);
+	return error;
+}
+#endif
+
+#ifdef HAVE_LIBZSTD
+static const char *decode_zstd(fit_decompress_t *job)
+{
+	ZSTD_DStream *ds = ZSTD_createDStream();
+	ZSTD_inBuffer in = { job->in, job->in_size, 0 };
+	const char *error = NULL;
+	size_t ret;
+
+	if (!ds)
+		return "failed to initialize libzstd";
+	ZSTD_initDStream(ds);
+	do {
+		size_t avail;
+		ZSTD_outBuffer out = { out_space(job, &avail), 0, 0 };
+		out.size = avail;
+		ret = ZSTD_decompressStream(ds, &out, &in);
+		if (ZSTD_isError(ret)) {
+			error = ZSTD_getErrorName(ret);
+			break;
+		}
+		out_commit(job, out.pos, in.pos);
+		if (ret != 0 && in.pos == in.size && out.pos < out.size)
+			error = "truncated zstd data";
+	} while (!error && (ret != 0 || in.pos < in.size));
+	ZSTD_freeDStream(ds);
+	return error;
+}
+#endif
+
+static void *decompress_thread(void *arg)
+{
+	fit_decompress_t *job = arg;
+
+	switch (job->comp) {
+	case FIT_COMP_GZIP:
+		job->error = decode_gzip(job);
+		break;
+#ifdef HAVE_LIBLZMA
+	case FIT_COMP_LZMA:
+		job->error = decode_lzma(job);
+		break;
+#endif
+#ifdef HAVE_LIBLZ4
+	case FIT_COMP_LZ4:
+		job->error = decode_lz4(job);
+		break;
+#endif
+#ifdef HAVE_LIBZSTD
+	case FIT_COMP_ZSTD:
+		job->error = decode_zstd(job);
+		break;
+#endif
+	default:
+		job->error = "unsupported compression";
+	}
+
+	if (job->error) {
+		upload_chunk_free(job->chunk);
+	} else {
+		size_t avail;
+		out_space(job, &avail); /* make sure there is a final chunk */
+		job->chunk->last = true;
+		job->chunk->total = job->total;
+		/* account for trailing input that didn't produce any data */
+		job->in_done = job->in_size;
+		out_push(job);
+	}
+	job->chunk = NULL;
+	bqueue_close(job->queue);
+	return NULL;
+}
+
+fit_decompress_t *fit_decompress_start(fit_compression_t comp,
+				       const void *data, size_t size,
+				       uint32_t addr, bqueue_t *queue)
+{
+	fit_decompress_t *job = calloc(1, sizeof(*job));
+
+	if (!job) {
+		perror("Failed to allocate decompression job");
+		exit(1);
+	}
+	job->comp = comp;
+	job->in = data;
+	job->in_size = size;
+	job->addr = addr;
+	job->queue = queue;
+	job->thread = pipeline_thread_start(decompress_thread, job);
+	return job;
+}
+
+const char *fit_decompress_finish(fit_decompress_t *job)
+{
+	const char *error;
+
+	pipeline_thread_join(job->thread);
+	error = job->error;
+	free(job);
+	return error;
+}
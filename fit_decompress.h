@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2026  sunxi-tools developers
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _SUNXI_TOOLS_FIT_DECOMPRESS_H
+#define _SUNXI_TOOLS_FIT_DECOMPRESS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "pipeline.h"
+
+/* values of the "compression" property of FIT images */
+typedef enum {
+	FIT_COMP_NONE,
+	FIT_COMP_GZIP,
+	FIT_COMP_LZMA,
+	FIT_COMP_LZ4,
+	FIT_COMP_ZSTD,
+	FIT_COMP_UNKNOWN,
+} fit_compression_t;
+
+fit_compression_t fit_parse_compression(const char *name);
+bool fit_compression_supported(fit_compression_t comp);
+
+/*
+ * Decompress 'size' bytes at 'data' on a worker thread. The output gets
+ * passed to 'queue' as upload_chunk_t items of up to PIPELINE_CHUNK_SIZE,
+ * with addresses counting up from 'addr', and the queue gets closed at the
+ * end. Only the final chunk of a successfully decoded stream has 'last' set.
+ * Its 'total' is the uncompressed size.
+ */
+typedef struct fit_decompress fit_decompress_t;
+
+fit_decompress_t *fit_decompress_start(fit_compression_t comp,
+				       const void *data, size_t size,
+				       uint32_t addr, bqueue_t *queue);
+/* wait for the worker, returns an error message or NULL on success */
+const char *fit_decompress_finish(fit_decompress_t *job);
+
+#endif /* _SUNXI_TOOLS_FIT_DECOMPRESS_H */
@@ -16,11 +16,19 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <libfdt.h>
 
+#include "artifact_cache.h"
 #include "common.h"
+#include "crc32.h"
+#include "digest.h"
 #include "fel_lib.h"
 #include "fit_image.h"
+#include "fel_stats.h"
+#include "fit_decompress.h"
+#include "pipeline.h"
+#include "progress.h"
 
 /* defined in fel.c */
 extern bool verbose;
@@ -43,6 +51,12 @@ struct fit_image_info {
 	uint32_t entry_point;
 	uint8_t os;
 	uint8_t arch;
+	fit_compression_t compression;
+	int node;
+	const char *name;	/* node name */
+	uint32_t written;	/* bytes uploaded (after decompression) */
+	double time;		/* upload time in seconds */
+	bool uploaded;
 };
 
 static int fit_parse_os(const char *value)
@@ -116,6 +130,9 @@ static int fit_get_image_info(const void *fit, const char *name,
 	if (node < 0)
 		return -1;
 
+	memset(info, 0, sizeof(*info));
+	info->node = node;
+	info->name = name;
 	info->load_addr = fdt_getprop_u32(fit, node, "load");
 	info->entry_point = fdt_getprop_u32(fit, node, "entry");
 	info->description = fdt_getprop_str(fit, node, "description");
@@ -140,9 +157,14 @@ static int fit_get_image_info(const void *fit, const char *name,
 	info->os = fit_parse_os(fdt_getprop_str(fit, node, "os"));
 	info->arch = fit_parse_arch(fdt_getprop_str(fit, node, "arch"));
 
+	/*
+	 * The SPL can't decompress images, so this is done on the host,
+	 * while uploading. Which methods are available depends on the
+	 * libraries found at build time (only gzip is always there).
+	 */
 	str = fdt_getprop_str(fit, node, "compression");
-	/* The current SPL does not support compression either. */
-	if (str && strcmp(str, "none")) {
+	info->compression = fit_parse_compression(str);
+	if (!fit_compression_supported(info->compression)) {
 		printf("compression \"%s\" not supported for image \"%s\"\n",
 		       str, info->description);
 		return -2;
@@ -151,27 +173,290 @@ static int fit_get_image_info(const void *fit, const char *name,
 	return 0;
 }
 
+/*
+ * Verification of the "hash-*" subnodes of the images. Each image gets a
+ * worker thread that computes its digests while the data is being uploaded.
+ * fit_verify_hashes() collects the results, before anything gets started.
+ */
+#define FIT_MAX_HASHES		4
+
+typedef struct {
+	const char *algo;
+	const uint8_t *value;
+	int len;
+} fit_hash_t;
+
+typedef struct fit_hash_job {
+	const char *image;
+	const uint8_t *data;
+	size_t size;
+	fit_hash_t hash[FIT_MAX_HASHES];
+	unsigned int count;
+	const char *failed;	/* algorithm of the first mismatch, if any */
+	pipeline_thread_t *thread;
+	struct fit_hash_job *next;
+} fit_hash_job_t;
+
+static fit_hash_job_t *hash_jobs, **hash_jobs_tail = &hash_jobs;
+
+static bool fit_hash_supported(const char *algo)
+{
+	return !strcmp(algo, "crc32") || !strcmp(algo, "sha1") ||
+	       !strcmp(algo, "sha256");
+}
+
+/* compute the digest for 'algo', returns its length */
+static int fit_hash_digest(const char *algo, const uint8_t *data, size_t size,
+			   uint8_t *digest)
+{
+	sha1_ctx_t sha1;
+	sha256_ctx_t sha256;
+	uint32_t crc;
+
+	if (!strcmp(algo, "sha1")) {
+		sha1_init(&sha1);
+		sha1_update(&sha1, data, size);
+		sha1_final(&sha1, digest);
+		return SHA1_DIGEST_SIZE;
+	}
+	if (!strcmp(algo, "sha256")) {
+		sha256_init(&sha256);
+		sha256_update(&sha256, data, size);
+		sha256_final(&sha256, digest);
+		return SHA256_DIGEST_SIZE;
+	}
+
+	/* crc32, stored big-endian */
+	crc = crc32_update(0, data, size);
+	digest[0] = crc >> 24;
+	digest[1] = crc >> 16;
+	digest[2] = crc >> 8;
+	digest[3] = crc;
+	return 4;
+}
+
+static void *fit_hash_thread(void *arg)
+{
+	fit_hash_job_t *job = arg;
+	uint8_t digest[SHA256_DIGEST_SIZE];
+	unsigned int i;
+
+	for (i = 0; i < job->count && !job->failed; i++) {
+		fit_hash_t *hash = &job->hash[i];
+		int len = fit_hash_digest(hash->algo, job->data, job->size,
+					  digest);
+
+		if (len != hash->len || memcmp(digest, hash->value, len))
+			job->failed = hash->algo;
+	}
+	return NULL;
+}
+
+/* start checking the hashes of an image (in its stored, compressed form) */
+static void fit_hash_start(const void *fit, struct fit_image_info *img)
+{
+	fit_hash_job_t *job;
+	int node;
+
+	job = calloc(1, sizeof(*job));
+	if (!job)
+		pr_fatal("Failed to allocate FIT hash job\n");
+	job->image = img->description;
+	job->data = (const uint8_t *)img->data;
+	job->size = img->data_size;
+
+	for (node = fdt_first_subnode(fit, img->node);
+	     node >= 0;
+	     node = fdt_next_subnode(fit, node)) {
+		const char *algo;
+		fit_hash_t *hash;
+
+		if (strncmp(fdt_get_name(fit, node, NULL), "hash", 4))
+			continue;
+		algo = fdt_getprop_str(fit, node, "algo");
+		if (!algo || !fit_hash_supported(algo)) {
+			if (verbose)
+				printf("skipping \"%s\" hash of image \"%s\"\n",
+				       algo ? algo : "(none)", img->description);
+			continue;
+		}
+		if (job->count == FIT_MAX_HASHES)
+			break;
+		hash = &job->hash[job->count];
+		hash->value = fdt_getprop(fit, node, "value", &hash->len);
+		if (!hash->value)
+			pr_fatal("FIT image \"%s\": no value for %s hash\n",
+				 img->description, algo);
+		hash->algo = algo;
+		job->count++;
+	}
+	if (job->count == 0) {
+		free(job);
+		return;
+	}
+
+	job->thread = pipeline_thread_start(fit_hash_thread, job);
+	*hash_jobs_tail = job;
+	hash_jobs_tail = &job->next;
+}
+
+/* wait for all hash checks, abort if any of them failed */
+static void fit_verify_hashes(void)
+{
+	const char *failed = NULL;
+
+	while (hash_jobs) {
+		fit_hash_job_t *job = hash_jobs;
+
+		pipeline_thread_join(job->thread);
+		if (job->failed) {
+			pr_error("FIT image \"%s\": %s hash mismatch\n",
+				 job->image, job->failed);
+			failed = job->image;
+		} else {
+			if (verbose)
+				printf("verified %u hash(es) of image \"%s\"\n",
+				       job->count, job->image);
+		}
+		hash_jobs = job->next;
+		free(job);
+	}
+	hash_jobs_tail = &hash_jobs;
+	if (failed)
+		pr_fatal("Aborting, corrupt FIT image\n");
+}
+
 static int entry_arch;
 static uint32_t dtb_addr;
 
+/* payload name in the cache entry of an image's compressed data */
+#define FIT_CACHE_PAYLOAD	"decompressed"
+
+/*
+ * Upload a decompressed image from the artifact cache, in chunks. The CRC
+ * gets checked along the way, so a damaged payload is only noticed at the
+ * end. The caller then decompresses the image again, overwriting it.
+ */
+static bool fit_write_cached(feldev_handle *dev, artifact_payload_t *payload,
+			     uint32_t addr, size_t size)
+{
+	uint8_t *buf = malloc(PIPELINE_CHUNK_SIZE);
+	size_t done = 0, len;
+
+	while (buf && done < size) {
+		len = size - done < PIPELINE_CHUNK_SIZE ?
+		      size - done : PIPELINE_CHUNK_SIZE;
+		len = artifact_load_read(payload, buf, len);
+		if (len == 0)
+			break;
+		aw_fel_write_buffer(dev, buf, addr + done, len, false);
+		done += len;
+	}
+	free(buf);
+	return artifact_load_end(payload) && done == size;
+}
+
+/*
+ * Write the image data to 'addr' on the board, decompressing it on the fly
+ * if needed. A worker thread decodes the data in chunks, which get uploaded
+ * while the next ones are being produced, so the uncompressed image never
+ * has to be held in memory as a whole. Progress is reported in terms of the
+ * data stored in the FIT, so the total is known up front.
+ * With --cache, the decompressed data also gets streamed to the artifact
+ * cache, keyed by the compressed data, so later runs with the same image
+ * can upload it straight away.
+ * Returns the number of bytes written.
+ */
+static uint32_t fit_write_image(feldev_handle *dev, struct fit_image_info *img,
+				uint32_t addr)
+{
+	fit_decompress_t *job;
+	upload_chunk_t *chunk;
+	bqueue_t *queue;
+	const char *error;
+	artifact_t *art;
+	artifact_payload_t *payload;
+	size_t total = 0, size;
+
+	if (img->compression == FIT_COMP_NONE) {
+		aw_fel_write_buffer(dev, img->data, addr, img->data_size, true);
+		return img->data_size;
+	}
+
+	art = artifact_open(img->data, img->data_size);
+	payload = artifact_load_begin(art, FIT_CACHE_PAYLOAD, &size);
+	if (payload) {
+		if (verbose)
+			printf("using cached decompressed image \"%s\"\n",
+			       img->description);
+		if (fit_write_cached(dev, payload, addr, size)) {
+			progress_update(img->data_size);
+			artifact_close(art);
+			return size;
+		}
+		printf("Warning: cached image \"%s\" is damaged, decompressing it again\n",
+		       img->description);
+	}
+
+	payload = artifact_store_begin(art, FIT_CACHE_PAYLOAD);
+	queue = bqueue_new(PIPELINE_DEPTH);
+	job = fit_decompress_start(img->compression, img->data,
+				   img->data_size, addr, queue);
+	while ((chunk = bqueue_pop(queue)) != NULL) {
+		if (chunk->size > 0) {
+			aw_fel_write_buffer(dev, chunk->data, chunk->addr,
+					    chunk->size, false);
+			/* the chunks come in order, without gaps */
+			artifact_store_write(payload, chunk->data, chunk->size);
+		}
+		progress_update(chunk->progress);
+		if (chunk->last)
+			total = chunk->total;
+		upload_chunk_free(chunk);
+	}
+	error = fit_decompress_finish(job);
+	bqueue_free(queue);
+	artifact_store_end(payload, !error && total > 0);
+	artifact_close(art);
+	if (error)
+		pr_fatal("Failed to decompress image \"%s\": %s\n",
+			 img->description, error);
+	return total;
+}
+
 /*
- * Upload the image described by its fit_image_info struct to the board.
+ * Upload the image described by its fit_image_info struct to 'addr' on the
+ * board. Its upload gets a section of its own in the transfer statistics,
+ * so the report shows which image dominates the boot time.
+ */
+static void fit_upload_image(feldev_handle *dev, const void *fit,
+			     struct fit_image_info *img, uint32_t addr)
+{
+	char name[32];
+	double start;
+
+	snprintf(name, sizeof(name), "fit:%s", img->name);
+	fel_stats_command(name);
+	fit_hash_start(fit, img);
+	start = gettime();
+	img->written = fit_write_image(dev, img, addr);
+	img->time = gettime() - start;
+	img->uploaded = true;
+}
+
+/*
+ * Process the image described by its fit_image_info struct, after it has
+ * been uploaded to its load address.
  * Detect if an image contains an entry point and return that.
  * Set entry_arch to arm or arm64 on the way. Also detect the image
  * containing U-Boot and record its end address, so that the DTB can be
  * appended later on.
  * Returns the entry point if any is specified, or 0 otherwise.
  */
-static uint32_t fit_load_image(feldev_handle *dev, struct fit_image_info *img)
+static uint32_t fit_loaded_image(struct fit_image_info *img)
 {
 	uint32_t ret = 0;
 
-	if (verbose)
-		printf("loading image \"%s\" (%d bytes) to 0x%x\n",
-		       img->description, img->data_size, img->load_addr);
-	aw_fel_write_buffer(dev, img->data,
-			    img->load_addr, img->data_size, true);
-
 	if (img->entry_point != ~0U) {
 		ret = img->entry_point;
 		entry_arch = img->arch;
@@ -179,19 +464,182 @@ static uint32_t fit_load_image(feldev_handle *dev, struct fit_image_info *img)
 	/* either explicitly marked as U-Boot, or the first invalid one */
 	if (img->os == IH_OS_U_BOOT ||
 	    (!dtb_addr && img->os == IH_OS_INVALID))
-		dtb_addr = img->load_addr + img->data_size;
+		dtb_addr = img->load_addr + img->written;
 
 	return ret;
 }
 
-uint32_t load_fit_images(feldev_handle *dev, const void *fit,
-			 const char *dt_name, bool *use_aarch64)
+/* per-image timing, after all uploads */
+static void fit_print_summary(struct fit_image_info *imgs, unsigned int count,
+			      double elapsed)
+{
+	size_t total = 0;
+	unsigned int i;
+
+	for (i = 0; i < count; i++) {
+		printf("%-20s %9u bytes @ 0x%08x %8.3f s %8.1f kB/s\n",
+		       imgs[i].name, imgs[i].written, imgs[i].load_addr,
+		       imgs[i].time, kilo(rate(imgs[i].written, imgs[i].time)));
+		total += imgs[i].written;
+	}
+	printf("%-20s %9zu bytes %21.3f s %8.1f kB/s\n", "total", total,
+	       elapsed, kilo(rate(total, elapsed)));
+}
+
+/*
+ * Upload planning: the images with a known size (i.e. uncompressed ones)
+ * get sorted by load address, and checked for overlaps before anything is
+ * sent. Neighbours that are exactly adjacent are merged into a single bulk
+ * transfer. This saves FEL requests on the way to U-Boot, in particular for
+ * the appended DTB. Gaps are never filled, as they might hold something
+ * useful (or an image uploaded before).
+ */
+#define FIT_MAX_IMAGES		16	/* "firmware" and "loadables" */
+
+/* what got loaded, for fit_loaded_ranges() */
+static fit_range_t fit_ranges[FIT_MAX_IMAGES + 1];
+static unsigned int fit_range_count;
+
+static int fit_compare_load_addr(const void *a, const void *b)
+{
+	const struct fit_image_info *img_a = *(struct fit_image_info **)a;
+	const struct fit_image_info *img_b = *(struct fit_image_info **)b;
+
+	if (img_a->load_addr != img_b->load_addr)
+		return img_a->load_addr < img_b->load_addr ? -1 : 1;
+	return 0;
+}
+
+/* can 'next' be uploaded together with 'prev'? */
+static bool fit_can_merge(const struct fit_image_info *prev,
+			  const struct fit_image_info *next)
+{
+	return next->load_addr == prev->load_addr + prev->data_size;
+}
+
+/* sort 'plan', bail out on overlaps, returns the total size */
+static size_t fit_plan_uploads(struct fit_image_info **plan, unsigned int count)
+{
+	size_t total = 0;
+	unsigned int i;
+
+	qsort(plan, count, sizeof(*plan), fit_compare_load_addr);
+	for (i = 0; i < count; i++) {
+		uint64_t end = (uint64_t)plan[i]->load_addr + plan[i]->data_size;
+
+		if (end > 0x100000000ULL)
+			pr_fatal("FIT image \"%s\" exceeds the address space\n",
+				 plan[i]->name);
+		total += plan[i]->data_size;
+		if (i == 0)
+			continue;
+		end = (uint64_t)plan[i - 1]->load_addr + plan[i - 1]->data_size;
+		if (end > plan[i]->load_addr)
+			pr_fatal("FIT images \"%s\" (0x%08x-0x%08x) and \"%s\" (0x%08x) overlap\n",
+				 plan[i - 1]->name, plan[i - 1]->load_addr,
+				 (uint32_t)end, plan[i]->name,
+				 plan[i]->load_addr);
+	}
+	return total;
+}
+
+/* number of images from plan[0] on that can go into a single transfer */
+static unsigned int fit_merge_count(struct fit_image_info **plan,
+				    unsigned int count)
+{
+	unsigned int i;
+
+	for (i = 1; i < count; i++)
+		if (!fit_can_merge(plan[i - 1], plan[i]))
+			break;
+	return i;
+}
+
+/* upload a group of images (as merged by the planner) in one go */
+static void fit_upload_merged(feldev_handle *dev, const void *fit,
+			      struct fit_image_info **group, unsigned int count)
+{
+	uint32_t addr = group[0]->load_addr;
+	uint32_t size = group[count - 1]->load_addr +
+			group[count - 1]->data_size - addr;
+	char name[32] = "fit:";
+	unsigned int i;
+	uint8_t *buf;
+	double elapsed;
+
+	if (count == 1) {
+		fit_upload_image(dev, fit, group[0], addr);
+		return;
+	}
+
+	buf = malloc(size);
+	if (!buf)
+		pr_fatal("Failed to allocate FIT upload buffer\n");
+	for (i = 0; i < count; i++) {
+		memcpy(buf + group[i]->load_addr - addr, group[i]->data,
+		       group[i]->data_size);
+		if (strlen(name) + strlen(group[i]->name) + 2 < sizeof(name))
+			sprintf(name + strlen(name), "%s%s", i ? "+" : "",
+				group[i]->name);
+		fit_hash_start(fit, group[i]);
+	}
+	if (verbose)
+		printf("uploading %u images in one go (%u bytes) to 0x%x\n",
+		       count, size, addr);
+
+	fel_stats_command(name);
+	elapsed = gettime();
+	aw_fel_write_buffer(dev, buf, addr, size, true);
+	elapsed = gettime() - elapsed;
+	free(buf);
+
+	/* share the time out among the images, for the summary */
+	for (i = 0; i < count; i++) {
+		group[i]->written = group[i]->data_size;
+		group[i]->time = elapsed * group[i]->data_size / size;
+		group[i]->uploaded = true;
+	}
+}
+
+/*
+ * The size of compressed images is only known after decompressing them,
+ * so they can't be part of the plan. Instead check afterwards that 'img'
+ * didn't overwrite any image uploaded before, and bail out if it did.
+ */
+static void fit_check_loaded(const struct fit_image_info *imgs,
+			     unsigned int count,
+			     const struct fit_image_info *img)
+{
+	uint64_t start = img->load_addr, end = start + img->written;
+	unsigned int i;
+
+	for (i = 0; i < count; i++) {
+		uint64_t other = imgs[i].load_addr;
+
+		if (&imgs[i] == img || !imgs[i].uploaded || !imgs[i].written)
+			continue;
+		if (start < other + imgs[i].written && other < end)
+			pr_fatal("FIT image \"%s\" (0x%08x-0x%08x) overwrote \"%s\" (0x%08x-0x%08x)\n",
+				 img->name, img->load_addr, (uint32_t)end,
+				 imgs[i].name, imgs[i].load_addr,
+				 (uint32_t)(other + imgs[i].written));
+	}
+}
+
+static uint32_t fit_load_configuration(feldev_handle *dev, const void *fit,
+				       const char *dt_name, bool *use_aarch64,
+				       progress_cb_t callback)
 {
 	const struct fdt_property *prop;
-	struct fit_image_info img;
+	struct fit_image_info imgs[FIT_MAX_IMAGES + 1], *dtb = NULL;
+	struct fit_image_info *plan[FIT_MAX_IMAGES + 1], *uboot = NULL;
+	unsigned int i, count = 0, planned = 0, merged;
+	bool dtb_late = false;
 	const char *str;
 	int node, len;
 	uint32_t entry_point = 0;
+	size_t total = 0;
+	double start;
 
 	node = fdt_path_offset(fit, "/configurations");
 	if (node < 0) {
@@ -232,29 +680,77 @@ uint32_t load_fit_images(feldev_handle *dev, const void *fit,
 	entry_arch = IH_ARCH_INVALID;
 	dtb_addr = 0;
 
-	/* Load the image described as "firmware". */
+	/*
+	 * Collect all images first: the image described as "firmware", and
+	 * all loadables. This gives the total size for the progress display.
+	 */
 	str = fdt_getprop_str(fit, node, "firmware");
-	if (str && !fit_get_image_info(fit, str, &img)) {
-		uint32_t addr = fit_load_image(dev, &img);
-
-		if (addr != 0)
-			entry_point = addr;
-	} else {
+	if (str && !fit_get_image_info(fit, str, &imgs[count]))
+		count++;
+	else
 		printf("WARNING: no valid \"firmware\" image entry in FIT\n");
-	}
 
-	/* load all loadables, at their respective load addresses */
 	prop = fdt_get_property(fit, node, "loadables", &len);
 	for (str = prop ? prop->data : NULL;
 	     prop && (str - prop->data) < len && *str;
 	     str += strlen(str) + 1) {
-		uint32_t addr;
-
-		if (fit_get_image_info(fit, str, &img)) {
+		if (count == FIT_MAX_IMAGES) {
+			printf("Too many loadables, skipping \"%s\".\n", str);
+			continue;
+		}
+		if (fit_get_image_info(fit, str, &imgs[count])) {
 			printf("Can't load loadable \"%s\", skipping.\n", str);
 			continue;
 		}
-		addr = fit_load_image(dev, &img);
+		count++;
+	}
+
+	str = fdt_getprop_str(fit, node, "fdt");
+	if (str && !fit_get_image_info(fit, str, &imgs[count]))
+		dtb = &imgs[count];
+
+	/*
+	 * The DTB gets appended to U-Boot. Its address is known up front if
+	 * U-Boot isn't compressed, so it can be part of the upload plan.
+	 */
+	for (i = 0; i < count; i++)
+		if (imgs[i].os == IH_OS_U_BOOT ||
+		    (!uboot && imgs[i].os == IH_OS_INVALID))
+			uboot = &imgs[i];
+	if (dtb && uboot && uboot->compression == FIT_COMP_NONE &&
+	    dtb->compression == FIT_COMP_NONE)
+		dtb->load_addr = uboot->load_addr + uboot->data_size;
+	else
+		dtb_late = true;
+
+	for (i = 0; i < count + (dtb && !dtb_late); i++)
+		if (imgs[i].compression == FIT_COMP_NONE)
+			plan[planned++] = &imgs[i];
+		else
+			total += imgs[i].data_size;
+	total += fit_plan_uploads(plan, planned);
+	if (dtb_late && dtb)
+		total += dtb->data_size;
+
+	/* load all images at their respective load addresses */
+	progress_start(callback, total);
+	start = gettime();
+	for (i = 0; i < planned; i += merged) {
+		merged = fit_merge_count(plan + i, planned - i);
+		fit_upload_merged(dev, fit, plan + i, merged);
+	}
+	for (i = 0; i < count; i++) {
+		uint32_t addr;
+
+		if (!imgs[i].uploaded) {
+			if (verbose)
+				printf("loading image \"%s\" (%d bytes) to 0x%x\n",
+				       imgs[i].description, imgs[i].data_size,
+				       imgs[i].load_addr);
+			fit_upload_image(dev, fit, &imgs[i], imgs[i].load_addr);
+			fit_check_loaded(imgs, count, &imgs[i]);
+		}
+		addr = fit_loaded_image(&imgs[i]);
 		if (addr != 0)
 			entry_point = addr;
 	}
@@ -264,19 +760,55 @@ uint32_t load_fit_images(feldev_handle *dev, const void *fit,
 
 	if (!dtb_addr) {
 		printf("Warning: no U-Boot image found, not loading DTB\n");
-		return entry_point;
+	} else if (!dtb) {
+		printf("Warning: no FDT found in FIT image\n");
+	} else {
+		/* load .dtb right after the U-Boot image (appended DTB) */
+		if (!dtb->uploaded) {
+			if (verbose)
+				printf("loading DTB \"%s\" (%d bytes)\n",
+				       dtb->description, dtb->data_size);
+			dtb->load_addr = dtb_addr;
+			fit_upload_image(dev, fit, dtb, dtb_addr);
+			fit_check_loaded(imgs, count + 1, dtb);
+		}
+		count++;
 	}
 
-	/* load .dtb right after the U-Boot image (appended DTB) */
-	str = fdt_getprop_str(fit, node, "fdt");
-	if (!str || fit_get_image_info(fit, str, &img)) {
-		printf("Warning: no FDT found in FIT image\n");
-		return entry_point;
+	for (i = 0; i < count; i++) {
+		if (!imgs[i].uploaded || !imgs[i].written)
+			continue;
+		fit_ranges[fit_range_count].addr = imgs[i].load_addr;
+		fit_ranges[fit_range_count++].size = imgs[i].written;
 	}
+
 	if (verbose)
-		printf("loading DTB \"%s\" (%d bytes)\n", img.description,
-		       img.data_size);
-	aw_fel_write_buffer(dev, img.data, dtb_addr, img.data_size, false);
+		fit_print_summary(imgs, count, gettime() - start);
+
+	return entry_point;
+}
+
+/*
+ * The hashes of all images get checked in parallel to their upload. If any
+ * of them doesn't match, we bail out here, before U-Boot could be started.
+ */
+uint32_t load_fit_images(feldev_handle *dev, const void *fit,
+			 const char *dt_name, bool *use_aarch64,
+			 progress_cb_t callback)
+{
+	uint32_t entry_point;
+
+	fit_range_count = 0;
+	entry_point = fit_load_configuration(dev, fit, dt_name, use_aarch64,
+					     callback);
+	fel_stats_command("fit:verify");
+	fit_verify_hashes();
 
 	return entry_point;
 }
+
+unsigned int fit_loaded_ranges(const fit_range_t **ranges)
+{
+	*ranges = fit_ranges;
+	return fit_range_count;
+}
@@ -19,14 +19,29 @@
 
 #include <stdint.h>
 #include "fel_lib.h"
+#include "progress.h"
+
+/* an address range written by load_fit_images() */
+typedef struct {
+	uint32_t addr, size;
+} fit_range_t;
 
 /*
  * Load all images referenced in the given U-Boot FIT image. @dt_name will
  * be used to select one of the configurations. @use_aarch64 contains the
- * target architecture of the entry point.
+ * target architecture of the entry point. Progress is reported for all
+ * images together, through @callback (may be NULL).
  * Returns the entry point address of the image to be started.
  */
 uint32_t load_fit_images(feldev_handle *dev, const void *fit,
-			 const char *dt_name, bool *use_aarch64);
+			 const char *dt_name, bool *use_aarch64,
+			 progress_cb_t callback);
+
+/*
+ * The ranges of all images loaded by the last load_fit_images() call, as
+ * written to (i.e. after decompression, including the appended DTB).
+ * Returns their number.
+ */
+unsigned int fit_loaded_ranges(const fit_range_t **ranges);
 
 #endif
@@ -55,6 +55,7 @@
 # include <sys/mount.h> /* BLKRRPART */
 #endif
 #include "nand-common.h"
+#include "crc32.h"
 
 // so far, only known formats are for A10 and A20
 #if defined(A10)
@@ -104,7 +105,7 @@ static MBR *_get_mbr(int fd, int mbr_num, int force)
 			printf("version 0x%08x is not 0x%08x\n", mbr->version, MBR_VERSION);
 			return NULL;
 		}
-		if(*(__u32 *)mbr == calc_crc32((__u32 *)mbr + 1,MBR_SIZE - 4))
+		if(*(__u32 *)mbr == crc32_update(0, (__u32 *)mbr + 1, MBR_SIZE - 4))
 		{
 			printf("OK\n");
 			return mbr;
@@ -246,7 +247,7 @@ static int writembrs(int fd, char names[][MAX_NAME], __u32 start, __u32 *lens, u
 	for (i = 0; i < MBR_COPY_NUM; i++) {
 		mbr->index = i;
 		// calculate new checksum
-		*(__u32 *)mbr = calc_crc32((__u32 *)mbr + 1,MBR_SIZE - 4);
+		*(__u32 *)mbr = crc32_update(0, (__u32 *)mbr + 1, MBR_SIZE - 4);
 		lseek(fd,MBR_START_ADDRESS + MBR_SIZE*i,SEEK_SET);
 		write(fd,mbr,MBR_SIZE);
 	}
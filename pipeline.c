@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026  sunxi-tools developers
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**********************************************************************
+ * Building blocks for host-side producer/consumer transfer pipelines
+ **********************************************************************/
+#include "pipeline.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+struct bqueue {
+	pthread_mutex_t lock;
+	pthread_cond_t not_empty;
+	pthread_cond_t not_full;
+	void **items;
+	size_t depth;	/* capacity */
+	size_t head;	/* index of the oldest item */
+	size_t count;	/* number of queued items */
+	bool closed;
+};
+
+static void *pipeline_alloc(size_t size)
+{
+	void *result = calloc(1, size);
+	if (!result) {
+		perror("Failed to allocate pipeline memory");
+		exit(1);
+	}
+	return result;
+}
+
+bqueue_t *bqueue_new(size_t depth)
+{
+	bqueue_t *queue = pipeline_alloc(sizeof(bqueue_t));
+
+	queue->items = pipeline_alloc(depth * sizeof(void *));
+	queue->depth = depth;
+	pthread_mutex_init(&queue->lock, NULL);
+	pthread_cond_init(&queue->not_empty, NULL);
+	pthread_cond_init(&queue->not_full, NULL);
+	return queue;
+}
+
+void bqueue_free(bqueue_t *queue)
+{
+	if (!queue)
+		return;
+	pthread_cond_destroy(&queue->not_full);
+	pthread_cond_destroy(&queue->not_empty);
+	pthread_mutex_destroy(&queue->lock);
+	free(queue->items);
+	free(queue);
+}
+
+void bqueue_push(bqueue_t *queue, void *item)
+{
+	pthread_mutex_lock(&queue->lock);
+	while (queue->count == queue->depth && !queue->closed)
+		pthread_cond_wait(&queue->not_full, &queue->lock);
+	if (!queue->closed) {
+		queue->items[(queue->head + queue->count) % queue->depth] = item;
+		queue->count++;
+		pthread_cond_signal(&queue->not_empty);
+	}
+	pthread_mutex_unlock(&queue->lock);
+}
+
+void *bqueue_pop(bqueue_t *queue)
+{
+	void *item = NULL;
+
+	pthread_mutex_lock(&queue->lock);
+	while (queue->count == 0 && !queue->closed)
+		pthread_cond_wait(&queue->not_empty, &queue->lock);
+	if (queue->count > 0) {
+		item = queue->items[queue->head];
+		queue->head = (queue->head + 1) % queue->depth;
+		queue->count--;
+		pthread_cond_signal(&queue->not_full);
+	}
+	pthread_mutex_unlock(&queue->lock);
+	return item;
+}
+
+/* Signal "end of stream" to the consumer side */
+void bqueue_close(bqueue_t *queue)
+{
+	pthread_mutex_lock(&queue->lock);
+	queue->closed = true;
+	pthread_cond_broadcast(&queue->not_empty);
+	pthread_cond_broadcast(&queue->not_full);
+	pthread_mutex_unlock(&queue->lock);
+}
+
+upload_chunk_t *upload_chunk_new(size_t size)
+{
+	upload_chunk_t *chunk = pipeline_alloc(sizeof(upload_chunk_t));
+
+	chunk->data = malloc(size > 0 ? size : 1);
+	if (!chunk->data) {
+		perror("Failed to allocate pipeline chunk");
+		exit(1);
+	}
+	return chunk;
+}
+
+void upload_chunk_free(upload_chunk_t *chunk)
+{
+	if (chunk) {
+		free(chunk->data);
+		free(chunk);
+	}
+}
+
+struct pipeline_thread {
+	pthread_t thread;
+};
+
+pipeline_thread_t *pipeline_thread_start(void *(*func)(void *), void *arg)
+{
+	pipeline_thread_t *result = pipeline_alloc(sizeof(pipeline_thread_t));
+
+	if (pthread_create(&result->thread, NULL, func, arg) != 0) {
+		fprintf(stderr, "FAILED to start pipeline thread\n");
+		exit(1);
+	}
+	return result;
+}
+
+void *pipeline_thread_join(pipeline_thread_t *thread)
+{
+	void *retval = NULL;
+
+	pthread_join(thread->thread, &retval);
+	free(thread);
+	return retval;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2026  sunxi-tools developers
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _SUNXI_TOOLS_PIPELINE_H
+#define _SUNXI_TOOLS_PIPELINE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * A bounded FIFO queue, used to connect the stages of a host-side transfer
+ * pipeline (e.g. file reader -> USB sender). Producers block while the queue
+ * is full, consumers block while it is empty. Closing the queue wakes up all
+ * waiters; bqueue_pop() then drains the remaining items and returns NULL
+ * afterwards.
+ */
+typedef struct bqueue bqueue_t;
+
+bqueue_t *bqueue_new(size_t depth);
+void bqueue_free(bqueue_t *queue);
+void bqueue_push(bqueue_t *queue, void *item);
+void *bqueue_pop(bqueue_t *queue);
+void bqueue_close(bqueue_t *queue);
+
+/*
+ * A unit of data travelling through an upload pipeline. The payload is
+ * owned by the chunk, and released with upload_chunk_free().
+ */
+typedef struct {
+	uint32_t addr;		/* target address on the device */
+	uint8_t *data;		/* payload */
+	size_t size;		/* payload size in bytes */
+	size_t progress;	/* byte count to report as progress */
+	unsigned int index;	/* index of the file/image this belongs to */
+	bool last;		/* marks the final chunk of a file/image */
+	int image_type;		/* result of the validation stage */
+	size_t total;		/* total size of the file/image */
+} upload_chunk_t;
+
+upload_chunk_t *upload_chunk_new(size_t size);
+void upload_chunk_free(upload_chunk_t *chunk);
+
+/* Default chunk size and queue depth for upload pipelines */
+#define PIPELINE_CHUNK_SIZE	(1024 * 1024)
+#define PIPELINE_DEPTH		4
+
+/* Convenience wrappers around pthread_create() / pthread_join() */
+typedef struct pipeline_thread pipeline_thread_t;
+
+pipeline_thread_t *pipeline_thread_start(void *(*func)(void *), void *arg);
+void *pipeline_thread_join(pipeline_thread_t *thread);
+
+#endif /* _SUNXI_TOOLS_PIPELINE_H */
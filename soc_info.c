@@ -197,6 +197,44 @@ sram_swap_buffers no_sram_swap_buffers[] = {
 	{ .size = 0 }  /* End of the table */
 };
 
+const dma_info dma_a31 = {
+	.base = 0x01C02000,
+	.gate_reg = 0x01C20060, .gate_bit = 6,
+	.reset_reg = 0x01C202C0, .reset_bit = 6,
+};
+
+const dma_info dma_a23 = {
+	.base = 0x01C02000,
+	.gate_reg = 0x01C20060, .gate_bit = 6,
+	.reset_reg = 0x01C202C0, .reset_bit = 6,
+	.autogate_reg = 0x20,
+};
+
+const dma_info dma_v3s = {
+	.base = 0x01C02000,
+	.gate_reg = 0x01C20060, .gate_bit = 6,
+	.reset_reg = 0x01C202C0, .reset_bit = 6,
+	.autogate_reg = 0x20,
+	.burst_h3 = true,
+};
+
+const dma_info dma_h3 = {
+	.base = 0x01C02000,
+	.gate_reg = 0x01C20060, .gate_bit = 6,
+	.reset_reg = 0x01C202C0, .reset_bit = 6,
+	.autogate_reg = 0x28,
+	.burst_h3 = true,
+};
+
+const dma_info dma_h6 = {
+	.base = 0x03002000,
+	.gate_reg = 0x0300170C, .gate_bit = 0,
+	.reset_reg = 0x0300170C, .reset_bit = 16,
+	.mbus_gate_reg = 0x03001804, .mbus_gate_bit = 0,
+	.autogate_reg = 0x28,
+	.burst_h3 = true,
+};
+
 const watchdog_info wd_a10_compat = {
 	.reg_mode = 0x01C20C94,
 	.reg_mode_value = 3,
@@ -332,6 +370,7 @@ soc_info_t soc_info_table[] = {
 		.thunk_addr   = 0xA200, .thunk_size = 0x200,
 		.swap_buffers = a10_a13_a20_sram_swap_buffers,
 		.sram_size    = 48 * 1024,
+		.spl_settle_us = 250000, /* see aw_fel_wait_for_spl() */
 		.needs_l2en   = true,
 		.sid_base     = 0x01C23800,
 		.watchdog     = &wd_a10_compat,
@@ -342,6 +381,7 @@ soc_info_t soc_info_table[] = {
 		.thunk_addr   = 0xA200, .thunk_size = 0x200,
 		.swap_buffers = a10_a13_a20_sram_swap_buffers,
 		.sram_size    = 48 * 1024,
+		.spl_settle_us = 250000, /* see aw_fel_wait_for_spl() */
 		.needs_l2en   = true,
 		.sid_base     = 0x01C23800,
 		.watchdog     = &wd_a10_compat,
@@ -352,6 +392,7 @@ soc_info_t soc_info_table[] = {
 		.thunk_addr   = 0xA200, .thunk_size = 0x200,
 		.swap_buffers = a10_a13_a20_sram_swap_buffers,
 		.sram_size    = 48 * 1024,
+		.spl_settle_us = 250000, /* see aw_fel_wait_for_spl() */
 		.sid_base     = 0x01C23800,
 		.sid_sections = generic_2k_sid_maps,
 		.watchdog     = &wd_a10_compat,
@@ -365,6 +406,7 @@ soc_info_t soc_info_table[] = {
 		.sid_base     = 0x01C23800,
 		.sid_sections = generic_2k_sid_maps,
 		.watchdog     = &wd_h3_compat,
+		.dma          = &dma_a23,
 	},{
 		.soc_id       = 0x1633, /* Allwinner A31 */
 		.name         = "A31",
@@ -372,7 +414,9 @@ soc_info_t soc_info_table[] = {
 		.thunk_addr   = 0x22E00, .thunk_size = 0x200,
 		.swap_buffers = a31_sram_swap_buffers,
 		.sram_size    = 32 * 1024,
+		.spl_settle_us = 250000, /* see aw_fel_wait_for_spl() */
 		.watchdog     = &wd_h3_compat,
+		.dma          = &dma_a31,
 	},{
 		.soc_id       = 0x1667, /* Allwinner A33, R16 */
 		.name         = "A33",
@@ -383,6 +427,7 @@ soc_info_t soc_info_table[] = {
 		.sid_base     = 0x01C23800,
 		.sid_sections = generic_2k_sid_maps,
 		.watchdog     = &wd_h3_compat,
+		.dma          = &dma_a23,
 	},{
 		.soc_id       = 0x1689, /* Allwinner A64 */
 		.name         = "A64",
@@ -398,6 +443,7 @@ soc_info_t soc_info_table[] = {
 		/* Check L.NOP in the OpenRISC reset vector */
 		.needs_smc_workaround_if_zero_word_at_addr = 0x40004,
 		.watchdog     = &wd_h3_compat,
+		.dma          = &dma_h3,
 	},{
 		.soc_id       = 0x1639, /* Allwinner A80 */
 		.name         = "A80",
@@ -431,6 +477,7 @@ soc_info_t soc_info_table[] = {
 		.sid_offset   = 0x200,
 		.sid_sections = generic_2k_sid_maps,
 		.watchdog     = &wd_h3_compat,
+		.dma          = &dma_a23,
 	},{
 		.soc_id       = 0x1680, /* Allwinner H3, H2+ */
 		.name         = "H3",
@@ -446,6 +493,7 @@ soc_info_t soc_info_table[] = {
 		/* Check L.NOP in the OpenRISC reset vector */
 		.needs_smc_workaround_if_zero_word_at_addr = 0x40004,
 		.watchdog     = &wd_h3_compat,
+		.dma          = &dma_h3,
 	},{
 		.soc_id       = 0x1681, /* Allwinner V3s */
 		.name         = "V3s",
@@ -457,6 +505,7 @@ soc_info_t soc_info_table[] = {
 		.sid_base     = 0x01C23800,
 		.sid_sections = generic_2k_sid_maps,
 		.watchdog     = &wd_h3_compat,
+		.dma          = &dma_v3s,
 	},{
 		.soc_id       = 0x1708, /* Allwinner T7 */
 		.name         = "T7",
@@ -484,6 +533,7 @@ soc_info_t soc_info_table[] = {
 		/* Check L.NOP in the OpenRISC reset vector */
 		.needs_smc_workaround_if_zero_word_at_addr = 0x40004,
 		.watchdog     = &wd_h3_compat,
+		.dma          = &dma_h3,
 	},{
 		.soc_id       = 0x1701, /* Allwinner R40 */
 		.name         = "R40",
@@ -523,6 +573,7 @@ soc_info_t soc_info_table[] = {
 		/* Check L.NOP in the OpenRISC reset vector */
 		.needs_smc_workaround_if_zero_word_at_addr = 0x100004,
 		.watchdog     = &wd_h6_compat,
+		.dma          = &dma_h6,
 	},{
 		.soc_id       = 0x1816, /* Allwinner V536 */
 		.name         = "V536",
@@ -562,6 +613,7 @@ soc_info_t soc_info_table[] = {
 		.rvbar_reg_alt= 0x08100040,
 		.ver_reg      = 0x03000024,
 		.watchdog     = &wd_h6_compat,
+		.dma          = &dma_h6,
 	},{
 		.soc_id       = 0x1851, /* Allwinner R329 */
 		.name         = "R329",
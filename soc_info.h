@@ -61,6 +61,22 @@ typedef struct {
 	uint32_t reg_mode_value;
 } watchdog_info;
 
+/*
+ * Contains information on the (sun6i style) DMA controller, used for large
+ * on-device copies and fills
+ */
+typedef struct {
+	uint32_t base;		/* DMA controller base address */
+	uint32_t gate_reg;	/* bus clock gating register */
+	uint32_t gate_bit;
+	uint32_t reset_reg;	/* bus reset register */
+	uint32_t reset_bit;
+	uint32_t mbus_gate_reg;	/* MBUS clock gating register (0 = none) */
+	uint32_t mbus_gate_bit;
+	uint32_t autogate_reg;	/* offset of the auto gating register (0 = none) */
+	bool     burst_h3;	/* H3 style burst length encoding (1/4/8/16) */
+} dma_info;
+
 /*
  * sunxi sid sections
  */
@@ -94,9 +110,11 @@ typedef struct {
  * USB. The older SoC variants (A10/A13/A20/A31/A23) already have MMU enabled
  * and we only need to adjust section attributes. The BROM in newer SoC variants
  * (A33/A83T/H3) doesn't enable MMU any more, so we need to find some 16K of
- * spare space in SRAM to place the translation table there and specify it as
- * the 'mmu_tt_addr' field in the 'soc_sram_info' structure. The 'mmu_tt_addr'
- * address must be 16K aligned.
+ * spare space in SRAM to place the translation table there. This can be
+ * specified as the 'mmu_tt_addr' field in the 'soc_sram_info' structure (the
+ * address must be 16K aligned), otherwise sunxi-fel picks a free block within
+ * 'sram_size' that doesn't collide with the scratch area, the thunk or the
+ * swap buffers. With --mmu, this also happens at the start of a session.
  *
  * If an SoC has the "secure boot" fuse burned, it will enter FEL mode in
  * non-secure state, so with the SCR.NS bit set. Since in this mode the
@@ -130,12 +148,14 @@ typedef struct {
 	uint32_t           rvbar_reg_alt;/* alternative MMIO address of RVBARADDR0_L register */
 	uint32_t           ver_reg;      /* MMIO address of "Version Register" */
 	const watchdog_info *watchdog;   /* Used for reset */
+	const dma_info     *dma;         /* DMA controller (NULL = unsupported) */
 	bool               sid_fix;      /* Use SID workaround (read via register) */
 	/* Use I$ workaround (disable I$ before first write to prevent stale thunk */
 	bool               icache_fix;
 	/* Use SMC workaround (enter secure mode) if can't read from this address */
 	uint32_t           needs_smc_workaround_if_zero_word_at_addr;
 	uint32_t           sram_size;	/* Usable contiguous SRAM at spl_addr */
+	uint32_t           spl_settle_us;/* Delay before checking the SPL result */
 	sram_swap_buffers *swap_buffers;
 } soc_info_t;
 
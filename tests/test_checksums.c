@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2026  sunxi-tools developers
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * test_checksums.c
+ *
+ * Known-answer tests for crc32.c and digest.c. The CRC-32 gets compared
+ * against zlib for all lengths up to 3000 bytes at every alignment within
+ * 16 bytes, for a 1 MiB buffer, and when fed in pieces. The Makefile also
+ * builds this with -DCRC32_NO_HW, so the portable code gets covered on
+ * hosts that would otherwise use PCLMULQDQ or the ARMv8 CRC instructions.
+ * SHA-1 and SHA-256 get checked with the test vectors from FIPS 180.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "crc32.h"
+#include "digest.h"
+
+static int failures;
+
+static void check_crc(const uint8_t *buf, size_t len, const char *what)
+{
+	uint32_t want = crc32(0, buf, len);
+	uint32_t got = crc32_update(0, buf, len);
+
+	if (got != want) {
+		printf("FAIL: crc32 of %s (%zu bytes): got %08x, want %08x\n",
+		       what, len, got, want);
+		failures++;
+	}
+}
+
+static void test_crc32(void)
+{
+	size_t size = 1024 * 1024 + 16, len, offset, split;
+	uint8_t *buf = malloc(size);
+	uint32_t crc;
+
+	if (!buf) {
+		perror("malloc");
+		exit(2);
+	}
+	for (len = 0; len < size; len++)
+		buf[len] = rand();
+
+	for (offset = 0; offset < 16; offset++)
+		for (len = 0; len <= 3000; len++)
+			check_crc(buf + offset, len, "unaligned data");
+	check_crc(buf, 1024 * 1024, "1 MiB");
+	check_crc(buf + 7, 1024 * 1024 + 3, "1 MiB, unaligned");
+
+	/* chained updates must match a single pass */
+	for (split = 0; split <= 300; split += 7) {
+		crc = crc32_update(0, buf + 3, split);
+		crc = crc32_update(crc, buf + 3 + split, 4000 - split);
+		if (crc != crc32(0, buf + 3, 4000)) {
+			printf("FAIL: crc32 split at %zu\n", split);
+			failures++;
+		}
+	}
+	free(buf);
+}
+
+static void check_digest(const uint8_t *got, const char *want,
+			 size_t size, const char *what)
+{
+	char hex[2 * SHA256_DIGEST_SIZE + 1];
+	size_t i;
+
+	for (i = 0; i < size; i++)
+		sprintf(hex + 2 * i, "%02x", got[i]);
+	if (strcmp(hex, want) != 0) {
+		printf("FAIL: %s: got %s, want %s\n", what, hex, want);
+		failures++;
+	}
+}
+
+static void test_digests(void)
+{
+	static const char *const msg[] = {
+		"abc",
+		"",
+		"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+	};
+	static const char *const sha1[] = {
+		"a9993e364706816aba3e25717850c26c9cd0d89d",
+		"da39a3ee5e6b4b0d3255bfef95601890afd80709",
+		"84983e441c3bd26ebaae4aa1f95129e5e54670f1",
+		"34aa973cd4c4daa4f61eeb2bdbad27316534016f",
+	};
+	static const char *const sha256[] = {
+		"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+		"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+		"248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+		"cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0",
+	};
+	uint8_t digest[SHA256_DIGEST_SIZE], a[1000];
+	sha1_ctx_t ctx1;
+	sha256_ctx_t ctx256;
+	size_t i;
+
+	for (i = 0; i < sizeof(msg) / sizeof(msg[0]); i++) {
+		sha1_init(&ctx1);
+		sha1_update(&ctx1, msg[i], strlen(msg[i]));
+		sha1_final(&ctx1, digest);
+		check_digest(digest, sha1[i], SHA1_DIGEST_SIZE, msg[i]);
+
+		sha256_init(&ctx256);
+		sha256_update(&ctx256, msg[i], strlen(msg[i]));
+		sha256_final(&ctx256, digest);
+		check_digest(digest, sha256[i], SHA256_DIGEST_SIZE, msg[i]);
+	}
+
+	/* one million times 'a', in pieces that don't match the block size */
+	memset(a, 'a', sizeof(a));
+	sha1_init(&ctx1);
+	sha256_init(&ctx256);
+	for (i = 0; i < 1000; i++) {
+		sha1_update(&ctx1, a, sizeof(a));
+		sha256_update(&ctx256, a, sizeof(a));
+	}
+	sha1_final(&ctx1, digest);
+	check_digest(digest, sha1[3], SHA1_DIGEST_SIZE, "a x 1000000");
+	sha256_final(&ctx256, digest);
+	check_digest(digest, sha256[3], SHA256_DIGEST_SIZE, "a x 1000000");
+}
+
+int main(void)
+{
+	test_crc32();
+	test_digests();
+	if (failures) {
+		printf("%d checksum test(s) failed\n", failures);
+		return 1;
+	}
+	printf("checksum tests passed\n");
+	return 0;
+}
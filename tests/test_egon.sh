@@ -0,0 +1,47 @@
+#!/bin/bash
+#
+# === Round trip of "sunxi-egon": build, verify, corrupt, stamp ===
+#
+# Copyright (C) 2026  sunxi-tools developers
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+EGON=../sunxi-egon
+TMPDIR=$(mktemp -d)
+trap 'rm -rf ${TMPDIR}' EXIT
+
+fail() {
+	echo "FAIL: $*"
+	exit 1
+}
+
+# some "code" of an odd size, so the build has to pad it
+head -c 12345 /dev/urandom > ${TMPDIR}/code.bin
+${EGON} -q build ${TMPDIR}/code.bin ${TMPDIR}/spl.bin || fail "build"
+${EGON} -q verify ${TMPDIR}/spl.bin || fail "verify after build"
+
+# flip one byte of the payload: the checksum must no longer match
+printf '\xa5' | dd of=${TMPDIR}/spl.bin bs=1 seek=1000 conv=notrunc 2> /dev/null
+OUTPUT=$(${EGON} verify ${TMPDIR}/spl.bin 2>&1)
+[ $? -eq 1 ] || fail "verify of a corrupt image didn't exit with 1"
+echo "${OUTPUT}" | grep -q "checksum" || fail "no checksum mismatch reported"
+
+# directory mode finds it as well
+${EGON} -q verify ${TMPDIR} 2> /dev/null && fail "verify of the directory"
+
+${EGON} -q stamp ${TMPDIR}/spl.bin || fail "stamp"
+${EGON} -q verify ${TMPDIR}/spl.bin || fail "verify after stamp"
+${EGON} -q verify ${TMPDIR} || fail "verify of the directory after stamp"
+
+echo "sunxi-egon tests passed"
@@ -0,0 +1,51 @@
+		/* <dma_xfer>: */
+		htole32(0xe92d41f0), /*    0:  push  {r4, r5, r6, r7, r8, lr} */
+		htole32(0xe59d4018), /*    4:  ldr   r4, [sp, #24]           */
+		htole32(0xe59d501c), /*    8:  ldr   r5, [sp, #28]           */
+		htole32(0xe24dd020), /*    c:  sub   sp, sp, #32             */
+		htole32(0xe58d5018), /*   10:  str   r5, [sp, #24]           */
+		htole32(0xe3a08001), /*   14:  mov   r8, #1                  */
+		htole32(0xe3530000), /*   18:  cmp   r3, #0                  */
+		htole32(0x028d3018), /*   1c:  addeq r3, sp, #24             */
+		htole32(0x03811020), /*   20:  orreq r1, r1, #32             */
+		htole32(0x03a08000), /*   24:  moveq r8, #0                  */
+		htole32(0xe2806c01), /*   28:  add   r6, r0, #256            */
+		/* <next_chunk>: */
+		htole32(0xe3540000), /*   2c:  cmp   r4, #0                  */
+		htole32(0x03a00000), /*   30:  moveq r0, #0                  */
+		htole32(0x0a00001f), /*   34:  beq   b8 <done>               */
+		htole32(0xe3a07502), /*   38:  mov   r7, #8388608            */
+		htole32(0xe1540007), /*   3c:  cmp   r4, r7                  */
+		htole32(0x31a07004), /*   40:  movlo r7, r4                  */
+		htole32(0xe88d000a), /*   44:  stm   sp, {r1, r3}            */
+		htole32(0xe58d2008), /*   48:  str   r2, [sp, #8]            */
+		htole32(0xe58d700c), /*   4c:  str   r7, [sp, #12]           */
+		htole32(0xe3a05000), /*   50:  mov   r5, #0                  */
+		htole32(0xe58d5010), /*   54:  str   r5, [sp, #16]           */
+		htole32(0xe30f5800), /*   58:  movw  r5, #63488              */
+		htole32(0xe34f5fff), /*   5c:  movt  r5, #65535              */
+		htole32(0xe58d5014), /*   60:  str   r5, [sp, #20]           */
+		htole32(0xf57ff04f), /*   64:  dsb   sy                      */
+		htole32(0xe1a0500d), /*   68:  mov   r5, sp                  */
+		htole32(0xe5865008), /*   6c:  str   r5, [r6, #8]            */
+		htole32(0xe3a05001), /*   70:  mov   r5, #1                  */
+		htole32(0xe5865000), /*   74:  str   r5, [r6]                */
+		htole32(0xe3a05301), /*   78:  mov   r5, #67108864           */
+		htole32(0xe590e030), /*   7c:  ldr   lr, [r0, #48]           */
+		htole32(0xe31e0001), /*   80:  tst   lr, #1                  */
+		htole32(0x0a000004), /*   84:  beq   9c <next_chunk+0x70>    */
+		htole32(0xe2555001), /*   88:  subs  r5, r5, #1              */
+		htole32(0x1afffffa), /*   8c:  bne   7c <next_chunk+0x50>    */
+		htole32(0xe5865000), /*   90:  str   r5, [r6]                */
+		htole32(0xe3a00001), /*   94:  mov   r0, #1                  */
+		htole32(0xea000006), /*   98:  b     b8 <done>               */
+		htole32(0xe3a05000), /*   9c:  mov   r5, #0                  */
+		htole32(0xe5865000), /*   a0:  str   r5, [r6]                */
+		htole32(0xe0822007), /*   a4:  add   r2, r2, r7              */
+		htole32(0xe3580000), /*   a8:  cmp   r8, #0                  */
+		htole32(0x10833007), /*   ac:  addne r3, r3, r7              */
+		htole32(0xe0444007), /*   b0:  sub   r4, r4, r7              */
+		htole32(0xeaffffdc), /*   b4:  b     2c <next_chunk>         */
+		/* <done>: */
+		htole32(0xe28dd020), /*   b8:  add   sp, sp, #32             */
+		htole32(0xe8bd81f0), /*   bc:  pop   {r4, r5, r6, r7, r8, pc} */
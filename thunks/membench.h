@@ -0,0 +1,175 @@
+		/* <membench>: */
+		htole32(0xe92d4ff1), /*    0:  push  {r0, r4, r5, r6, r7, r8, r9, r10, r11, lr} */
+		htole32(0xe3100c01), /*    4:  tst   r0, #256                */
+		htole32(0x0a000005), /*    8:  beq   24 <membench+0x24>      */
+		htole32(0xee194f1c), /*    c:  mrc   p15, #0, r4, c9, c12, #0 */
+		htole32(0xe3844001), /*   10:  orr   r4, r4, #1              */
+		htole32(0xe3c44008), /*   14:  bic   r4, r4, #8              */
+		htole32(0xee094f1c), /*   18:  mcr   p15, #0, r4, c9, c12, #0 */
+		htole32(0xe3a04102), /*   1c:  mov   r4, #-2147483648        */
+		htole32(0xee094f3c), /*   20:  mcr   p15, #0, r4, c9, c12, #1 */
+		htole32(0xe20040ff), /*   24:  and   r4, r0, #255            */
+		htole32(0xe2445004), /*   28:  sub   r5, r4, #4              */
+		htole32(0xe3550002), /*   2c:  cmp   r5, #2                  */
+		htole32(0x8a000005), /*   30:  bhi   4c <membench+0x4c>      */
+		htole32(0xee115f50), /*   34:  mrc   p15, #0, r5, c1, c0, #2 */
+		htole32(0xe385560f), /*   38:  orr   r5, r5, #15728640       */
+		htole32(0xee015f50), /*   3c:  mcr   p15, #0, r5, c1, c0, #2 */
+		htole32(0xf57ff06f), /*   40:  isb   sy                      */
+		htole32(0xe3a05101), /*   44:  mov   r5, #1073741824         */
+		htole32(0xeee85a10), /*   48:  vmsr  fpexc, r5               */
+		htole32(0xe0812002), /*   4c:  add   r2, r1, r2              */
+		htole32(0xe3a00000), /*   50:  mov   r0, #0                  */
+		htole32(0xe3540007), /*   54:  cmp   r4, #7                  */
+		htole32(0x908ff104), /*   58:  addls pc, pc, r4, lsl #2      */
+		htole32(0xea000089), /*   5c:  b     288 <done>              */
+		htole32(0xea000006), /*   60:  b     80 <read>               */
+		htole32(0xea000011), /*   64:  b     b0 <write>              */
+		htole32(0xea000024), /*   68:  b     100 <copy>              */
+		htole32(0xea000034), /*   6c:  b     144 <chase>             */
+		htole32(0xea000043), /*   70:  b     184 <neon_read>         */
+		htole32(0xea00004e), /*   74:  b     1b4 <neon_write>        */
+		htole32(0xea00005b), /*   78:  b     1ec <neon_copy>         */
+		htole32(0xea00006b), /*   7c:  b     230 <chase_init>        */
+		/* <read>: */
+		htole32(0xe59d0000), /*   80:  ldr   r0, [sp]                */
+		htole32(0xe3100c01), /*   84:  tst   r0, #256                */
+		htole32(0x1e19ef1d), /*   88:  mrcne p15, #0, lr, c9, c13, #0 */
+		htole32(0x0c50ef0e), /*   8c:  mrrceq p15, #0, lr, r0, c14    */
+		htole32(0xe1a00001), /*   90:  mov   r0, r1                  */
+		htole32(0xe8b00ff0), /*   94:  ldm   r0!, {r4, r5, r6, r7, r8, r9, r10, r11} */
+		htole32(0xe8b00ff0), /*   98:  ldm   r0!, {r4, r5, r6, r7, r8, r9, r10, r11} */
+		htole32(0xe1500002), /*   9c:  cmp   r0, r2                  */
+		htole32(0x3afffffb), /*   a0:  blo   94 <read+0x14>          */
+		htole32(0xe2533001), /*   a4:  subs  r3, r3, #1              */
+		htole32(0x1afffff8), /*   a8:  bne   90 <read+0x10>          */
+		htole32(0xea000070), /*   ac:  b     274 <finish>            */
+		/* <write>: */
+		htole32(0xe3a04000), /*   b0:  mov   r4, #0                  */
+		htole32(0xe3a05000), /*   b4:  mov   r5, #0                  */
+		htole32(0xe3a06000), /*   b8:  mov   r6, #0                  */
+		htole32(0xe3a07000), /*   bc:  mov   r7, #0                  */
+		htole32(0xe3a08000), /*   c0:  mov   r8, #0                  */
+		htole32(0xe3a09000), /*   c4:  mov   r9, #0                  */
+		htole32(0xe3a0a000), /*   c8:  mov   r10, #0                 */
+		htole32(0xe3a0b000), /*   cc:  mov   r11, #0                 */
+		htole32(0xe59d0000), /*   d0:  ldr   r0, [sp]                */
+		htole32(0xe3100c01), /*   d4:  tst   r0, #256                */
+		htole32(0x1e19ef1d), /*   d8:  mrcne p15, #0, lr, c9, c13, #0 */
+		htole32(0x0c50ef0e), /*   dc:  mrrceq p15, #0, lr, r0, c14    */
+		htole32(0xe1a00001), /*   e0:  mov   r0, r1                  */
+		htole32(0xe8a00ff0), /*   e4:  stm   r0!, {r4, r5, r6, r7, r8, r9, r10, r11} */
+		htole32(0xe8a00ff0), /*   e8:  stm   r0!, {r4, r5, r6, r7, r8, r9, r10, r11} */
+		htole32(0xe1500002), /*   ec:  cmp   r0, r2                  */
+		htole32(0x3afffffb), /*   f0:  blo   e4 <write+0x34>         */
+		htole32(0xe2533001), /*   f4:  subs  r3, r3, #1              */
+		htole32(0x1afffff8), /*   f8:  bne   e0 <write+0x30>         */
+		htole32(0xea00005c), /*   fc:  b     274 <finish>            */
+		/* <copy>: */
+		htole32(0xe0422001), /*  100:  sub   r2, r2, r1              */
+		htole32(0xe08120a2), /*  104:  add   r2, r1, r2, lsr #1      */
+		htole32(0xe59d0000), /*  108:  ldr   r0, [sp]                */
+		htole32(0xe3100c01), /*  10c:  tst   r0, #256                */
+		htole32(0x1e19ef1d), /*  110:  mrcne p15, #0, lr, c9, c13, #0 */
+		htole32(0x0c50ef0e), /*  114:  mrrceq p15, #0, lr, r0, c14    */
+		htole32(0xe1a00001), /*  118:  mov   r0, r1                  */
+		htole32(0xe1a0c002), /*  11c:  mov   r12, r2                 */
+		htole32(0xe8b00ff0), /*  120:  ldm   r0!, {r4, r5, r6, r7, r8, r9, r10, r11} */
+		htole32(0xe8ac0ff0), /*  124:  stm   r12!, {r4, r5, r6, r7, r8, r9, r10, r11} */
+		htole32(0xe8b00ff0), /*  128:  ldm   r0!, {r4, r5, r6, r7, r8, r9, r10, r11} */
+		htole32(0xe8ac0ff0), /*  12c:  stm   r12!, {r4, r5, r6, r7, r8, r9, r10, r11} */
+		htole32(0xe1500002), /*  130:  cmp   r0, r2                  */
+		htole32(0x3afffff9), /*  134:  blo   120 <copy+0x20>         */
+		htole32(0xe2533001), /*  138:  subs  r3, r3, #1              */
+		htole32(0x1afffff5), /*  13c:  bne   118 <copy+0x18>         */
+		htole32(0xea00004b), /*  140:  b     274 <finish>            */
+		/* <chase>: */
+		htole32(0xe59d0000), /*  144:  ldr   r0, [sp]                */
+		htole32(0xe3100c01), /*  148:  tst   r0, #256                */
+		htole32(0x1e19ef1d), /*  14c:  mrcne p15, #0, lr, c9, c13, #0 */
+		htole32(0x0c50ef0e), /*  150:  mrrceq p15, #0, lr, r0, c14    */
+		htole32(0xe1a00001), /*  154:  mov   r0, r1                  */
+		htole32(0xe5900000), /*  158:  ldr   r0, [r0]                */
+		htole32(0xe5900000), /*  15c:  ldr   r0, [r0]                */
+		htole32(0xe5900000), /*  160:  ldr   r0, [r0]                */
+		htole32(0xe5900000), /*  164:  ldr   r0, [r0]                */
+		htole32(0xe5900000), /*  168:  ldr   r0, [r0]                */
+		htole32(0xe5900000), /*  16c:  ldr   r0, [r0]                */
+		htole32(0xe5900000), /*  170:  ldr   r0, [r0]                */
+		htole32(0xe5900000), /*  174:  ldr   r0, [r0]                */
+		htole32(0xe2533008), /*  178:  subs  r3, r3, #8              */
+		htole32(0x8afffff5), /*  17c:  bhi   158 <chase+0x14>        */
+		htole32(0xea00003b), /*  180:  b     274 <finish>            */
+		/* <neon_read>: */
+		htole32(0xe59d0000), /*  184:  ldr   r0, [sp]                */
+		htole32(0xe3100c01), /*  188:  tst   r0, #256                */
+		htole32(0x1e19ef1d), /*  18c:  mrcne p15, #0, lr, c9, c13, #0 */
+		htole32(0x0c50ef0e), /*  190:  mrrceq p15, #0, lr, r0, c14    */
+		htole32(0xe1a00001), /*  194:  mov   r0, r1                  */
+		htole32(0xf42002ed), /*  198:  vld1.64 {d0, d1, d2, d3}, [r0:128]! */
+		htole32(0xf42042ed), /*  19c:  vld1.64 {d4, d5, d6, d7}, [r0:128]! */
+		htole32(0xe1500002), /*  1a0:  cmp   r0, r2                  */
+		htole32(0x3afffffb), /*  1a4:  blo   198 <neon_read+0x14>    */
+		htole32(0xe2533001), /*  1a8:  subs  r3, r3, #1              */
+		htole32(0x1afffff8), /*  1ac:  bne   194 <neon_read+0x10>    */
+		htole32(0xea00002f), /*  1b0:  b     274 <finish>            */
+		/* <neon_write>: */
+		htole32(0xf2800e50), /*  1b4:  vmov.i8 q0, #0x0                */
+		htole32(0xf2802e50), /*  1b8:  vmov.i8 q1, #0x0                */
+		htole32(0xe59d0000), /*  1bc:  ldr   r0, [sp]                */
+		htole32(0xe3100c01), /*  1c0:  tst   r0, #256                */
+		htole32(0x1e19ef1d), /*  1c4:  mrcne p15, #0, lr, c9, c13, #0 */
+		htole32(0x0c50ef0e), /*  1c8:  mrrceq p15, #0, lr, r0, c14    */
+		htole32(0xe1a00001), /*  1cc:  mov   r0, r1                  */
+		htole32(0xf40002ed), /*  1d0:  vst1.64 {d0, d1, d2, d3}, [r0:128]! */
+		htole32(0xf40002ed), /*  1d4:  vst1.64 {d0, d1, d2, d3}, [r0:128]! */
+		htole32(0xe1500002), /*  1d8:  cmp   r0, r2                  */
+		htole32(0x3afffffb), /*  1dc:  blo   1d0 <neon_write+0x1c>   */
+		htole32(0xe2533001), /*  1e0:  subs  r3, r3, #1              */
+		htole32(0x1afffff8), /*  1e4:  bne   1cc <neon_write+0x18>   */
+		htole32(0xea000021), /*  1e8:  b     274 <finish>            */
+		/* <neon_copy>: */
+		htole32(0xe0422001), /*  1ec:  sub   r2, r2, r1              */
+		htole32(0xe08120a2), /*  1f0:  add   r2, r1, r2, lsr #1      */
+		htole32(0xe59d0000), /*  1f4:  ldr   r0, [sp]                */
+		htole32(0xe3100c01), /*  1f8:  tst   r0, #256                */
+		htole32(0x1e19ef1d), /*  1fc:  mrcne p15, #0, lr, c9, c13, #0 */
+		htole32(0x0c50ef0e), /*  200:  mrrceq p15, #0, lr, r0, c14    */
+		htole32(0xe1a00001), /*  204:  mov   r0, r1                  */
+		htole32(0xe1a0c002), /*  208:  mov   r12, r2                 */
+		htole32(0xf42002ed), /*  20c:  vld1.64 {d0, d1, d2, d3}, [r0:128]! */
+		htole32(0xf42042ed), /*  210:  vld1.64 {d4, d5, d6, d7}, [r0:128]! */
+		htole32(0xf40c02ed), /*  214:  vst1.64 {d0, d1, d2, d3}, [r12:128]! */
+		htole32(0xf40c42ed), /*  218:  vst1.64 {d4, d5, d6, d7}, [r12:128]! */
+		htole32(0xe1500002), /*  21c:  cmp   r0, r2                  */
+		htole32(0x3afffff9), /*  220:  blo   20c <neon_copy+0x20>    */
+		htole32(0xe2533001), /*  224:  subs  r3, r3, #1              */
+		htole32(0x1afffff5), /*  228:  bne   204 <neon_copy+0x18>    */
+		htole32(0xea000010), /*  22c:  b     274 <finish>            */
+		/* <chase_init>: */
+		htole32(0xe0422001), /*  230:  sub   r2, r2, r1              */
+		htole32(0xe1a03322), /*  234:  lsr   r3, r2, #6              */
+		htole32(0xe2432001), /*  238:  sub   r2, r3, #1              */
+		htole32(0xe306460d), /*  23c:  movw  r4, #26125              */
+		htole32(0xe3404019), /*  240:  movt  r4, #25                 */
+		htole32(0xe30f535f), /*  244:  movw  r5, #62303              */
+		htole32(0xe3435c6e), /*  248:  movt  r5, #15470              */
+		htole32(0xe3a06000), /*  24c:  mov   r6, #0                  */
+		htole32(0xe0275496), /*  250:  mla   r7, r6, r4, r5          */
+		htole32(0xe0077002), /*  254:  and   r7, r7, r2              */
+		htole32(0xe0818307), /*  258:  add   r8, r1, r7, lsl #6      */
+		htole32(0xe7818306), /*  25c:  str   r8, [r1, r6, lsl #6]    */
+		htole32(0xe1a06007), /*  260:  mov   r6, r7                  */
+		htole32(0xe2533001), /*  264:  subs  r3, r3, #1              */
+		htole32(0x1afffff8), /*  268:  bne   250 <chase_init+0x20>   */
+		htole32(0xe3a00000), /*  26c:  mov   r0, #0                  */
+		htole32(0xea000004), /*  270:  b     288 <done>              */
+		/* <finish>: */
+		htole32(0xe59d4000), /*  274:  ldr   r4, [sp]                */
+		htole32(0xe3140c01), /*  278:  tst   r4, #256                */
+		htole32(0x1e190f1d), /*  27c:  mrcne p15, #0, r0, c9, c13, #0 */
+		htole32(0x0c540f0e), /*  280:  mrrceq p15, #0, r0, r4, c14    */
+		htole32(0xe040000e), /*  284:  sub   r0, r0, lr              */
+		/* <done>: */
+		htole32(0xe28dd004), /*  288:  add   sp, sp, #4              */
+		htole32(0xe8bd8ff0), /*  28c:  pop   {r4, r5, r6, r7, r8, r9, r10, r11, pc} */
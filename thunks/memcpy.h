@@ -1,55 +1,185 @@
-		/* <fel_memcpy_up>: */
-		htole32(0xe59f0054), /*    0:  ldr   r0, [pc, #84]           */
-		htole32(0xe59f1054), /*    4:  ldr   r1, [pc, #84]           */
-		htole32(0xe59f2054), /*    8:  ldr   r2, [pc, #84]           */
-		htole32(0xe0413000), /*    c:  sub   r3, r1, r0              */
-		htole32(0xe3130003), /*   10:  tst   r3, #3                  */
-		htole32(0x1a00000b), /*   14:  bne   48 <copyup_tail>        */
-		/* <copyup_head>: */
-		htole32(0xe3110003), /*   18:  tst   r1, #3                  */
-		htole32(0x0a000004), /*   1c:  beq   34 <copyup_loop>        */
-		htole32(0xe4d13001), /*   20:  ldrb  r3, [r1], #1            */
-		htole32(0xe4c03001), /*   24:  strb  r3, [r0], #1            */
-		htole32(0xe2522001), /*   28:  subs  r2, r2, #1              */
-		htole32(0x5afffff9), /*   2c:  bpl   18 <copyup_head>        */
-		htole32(0xe12fff1e), /*   30:  bx    lr                      */
-		/* <copyup_loop>: */
-		htole32(0xe2522004), /*   34:  subs  r2, r2, #4              */
-		htole32(0x54913004), /*   38:  ldrpl r3, [r1], #4            */
-		htole32(0x54803004), /*   3c:  strpl r3, [r0], #4            */
-		htole32(0x5afffffb), /*   40:  bpl   34 <copyup_loop>        */
-		htole32(0xe2822004), /*   44:  add   r2, r2, #4              */
-		/* <copyup_tail>: */
-		htole32(0xe2522001), /*   48:  subs  r2, r2, #1              */
-		htole32(0x412fff1e), /*   4c:  bxmi  lr                      */
-		htole32(0xe4d13001), /*   50:  ldrb  r3, [r1], #1            */
-		htole32(0xe4c03001), /*   54:  strb  r3, [r0], #1            */
-		htole32(0xeafffffa), /*   58:  b     48 <copyup_tail>        */
-		/* <fel_memcpy_down>: */
-		htole32(0xe59f0058), /*   68:  ldr   r0, [pc, #88]           */
-		htole32(0xe59f1058), /*   6c:  ldr   r1, [pc, #88]           */
-		htole32(0xe59f2058), /*   70:  ldr   r2, [pc, #88]           */
-		htole32(0xe0403001), /*   74:  sub   r3, r0, r1              */
-		htole32(0xe3130003), /*   78:  tst   r3, #3                  */
-		htole32(0x1a00000c), /*   7c:  bne   b4 <copydn_tail>        */
-		/* <copydn_head>: */
-		htole32(0xe0813002), /*   80:  add   r3, r1, r2              */
-		htole32(0xe3130003), /*   84:  tst   r3, #3                  */
-		htole32(0x0a000004), /*   88:  beq   a0 <copydn_loop>        */
-		htole32(0xe2522001), /*   8c:  subs  r2, r2, #1              */
-		htole32(0x412fff1e), /*   90:  bxmi  lr                      */
-		htole32(0xe7d13002), /*   94:  ldrb  r3, [r1, r2]            */
-		htole32(0xe7c03002), /*   98:  strb  r3, [r0, r2]            */
-		htole32(0xeafffff7), /*   9c:  b     80 <copydn_head>        */
-		/* <copydn_loop>: */
-		htole32(0xe2522004), /*   a0:  subs  r2, r2, #4              */
-		htole32(0x57913002), /*   a4:  ldrpl r3, [r1, r2]            */
-		htole32(0x57803002), /*   a8:  strpl r3, [r0, r2]            */
-		htole32(0x5afffffb), /*   ac:  bpl   a0 <copydn_loop>        */
-		htole32(0xe2822004), /*   b0:  add   r2, r2, #4              */
-		/* <copydn_tail>: */
-		htole32(0xe2522001), /*   b4:  subs  r2, r2, #1              */
-		htole32(0x412fff1e), /*   b8:  bxmi  lr                      */
-		htole32(0xe7d13002), /*   bc:  ldrb  r3, [r1, r2]            */
-		htole32(0xe7c03002), /*   c0:  strb  r3, [r0, r2]            */
-		htole32(0xeafffffa), /*   c4:  b     b4 <copydn_tail>        */
+		/* <fel_memmove>: */
+		htole32(0xe92d4ff0), /*    0:  push  {r4, r5, r6, r7, r8, r9, r10, r11, lr} */
+		htole32(0xe59f02b8), /*    4:  ldr   r0, [pc, #696]          */
+		htole32(0xe59f12b8), /*    8:  ldr   r1, [pc, #696]          */
+		htole32(0xe59f22b8), /*    c:  ldr   r2, [pc, #696]          */
+		htole32(0xe59f32b8), /*   10:  ldr   r3, [pc, #696]          */
+		htole32(0xe3130001), /*   14:  tst   r3, #1                  */
+		htole32(0x1a000061), /*   18:  bne   1a4 <copy_down>         */
+		htole32(0xe3100003), /*   1c:  tst   r0, #3                  */
+		htole32(0x0a000004), /*   20:  beq   38 <fel_memmove+0x38>   */
+		htole32(0xe2522001), /*   24:  subs  r2, r2, #1              */
+		htole32(0x4a0000a4), /*   28:  bmi   2c0 <done>              */
+		htole32(0xe4d14001), /*   2c:  ldrb  r4, [r1], #1            */
+		htole32(0xe4c04001), /*   30:  strb  r4, [r0], #1            */
+		htole32(0xeafffff8), /*   34:  b     1c <fel_memmove+0x1c>   */
+		htole32(0xe3110003), /*   38:  tst   r1, #3                  */
+		htole32(0x1a00002d), /*   3c:  bne   f8 <up_shifted>         */
+		htole32(0xe3130002), /*   40:  tst   r3, #2                  */
+		htole32(0x0a000019), /*   44:  beq   b0 <up_ldm>             */
+		htole32(0xe3520040), /*   48:  cmp   r2, #64                 */
+		htole32(0x3a000017), /*   4c:  blo   b0 <up_ldm>             */
+		htole32(0xee104f10), /*   50:  mrc   p15, #0, r4, c0, c0, #0 */
+		htole32(0xe204480f), /*   54:  and   r4, r4, #983040         */
+		htole32(0xe354080f), /*   58:  cmp   r4, #983040             */
+		htole32(0x1a000013), /*   5c:  bne   b0 <up_ldm>             */
+		htole32(0xee114f50), /*   60:  mrc   p15, #0, r4, c1, c0, #2 */
+		htole32(0xe384460f), /*   64:  orr   r4, r4, #15728640       */
+		htole32(0xee014f50), /*   68:  mcr   p15, #0, r4, c1, c0, #2 */
+		htole32(0xf57ff06f), /*   6c:  isb   sy                      */
+		htole32(0xee114f50), /*   70:  mrc   p15, #0, r4, c1, c0, #2 */
+		htole32(0xe204460f), /*   74:  and   r4, r4, #15728640       */
+		htole32(0xe354060f), /*   78:  cmp   r4, #15728640           */
+		htole32(0x1a00000b), /*   7c:  bne   b0 <up_ldm>             */
+		htole32(0xe3a04101), /*   80:  mov   r4, #1073741824         */
+		htole32(0xeee84a10), /*   84:  vmsr  fpexc, r4               */
+		htole32(0xeef64a10), /*   88:  vmrs  r4, mvfr1               */
+		htole32(0xe3140c0f), /*   8c:  tst   r4, #3840               */
+		htole32(0x0a000006), /*   90:  beq   b0 <up_ldm>             */
+		htole32(0xe2522040), /*   94:  subs  r2, r2, #64             */
+		htole32(0xf421028d), /*   98:  vld1.32 {d0, d1, d2, d3}, [r1]! */
+		htole32(0xf421428d), /*   9c:  vld1.32 {d4, d5, d6, d7}, [r1]! */
+		htole32(0xf400028d), /*   a0:  vst1.32 {d0, d1, d2, d3}, [r0]! */
+		htole32(0xf400428d), /*   a4:  vst1.32 {d4, d5, d6, d7}, [r0]! */
+		htole32(0xe3520040), /*   a8:  cmp   r2, #64                 */
+		htole32(0x2afffff8), /*   ac:  bhs   94 <fel_memmove+0x94>   */
+		/* <up_ldm>: */
+		htole32(0xe2522020), /*   b0:  subs  r2, r2, #32             */
+		htole32(0x3a000003), /*   b4:  blo   c8 <up_ldm+0x18>        */
+		htole32(0xe8b10ff0), /*   b8:  ldm   r1!, {r4, r5, r6, r7, r8, r9, r10, r11} */
+		htole32(0xe8a00ff0), /*   bc:  stm   r0!, {r4, r5, r6, r7, r8, r9, r10, r11} */
+		htole32(0xe2522020), /*   c0:  subs  r2, r2, #32             */
+		htole32(0x2afffffb), /*   c4:  bhs   b8 <up_ldm+0x8>         */
+		htole32(0xe292201c), /*   c8:  adds  r2, r2, #28             */
+		htole32(0x3a000003), /*   cc:  blo   e0 <up_ldm+0x30>        */
+		htole32(0xe4914004), /*   d0:  ldr   r4, [r1], #4            */
+		htole32(0xe4804004), /*   d4:  str   r4, [r0], #4            */
+		htole32(0xe2522004), /*   d8:  subs  r2, r2, #4              */
+		htole32(0x2afffffb), /*   dc:  bhs   d0 <up_ldm+0x20>        */
+		htole32(0xe2822004), /*   e0:  add   r2, r2, #4              */
+		/* <up_bytes>: */
+		htole32(0xe2522001), /*   e4:  subs  r2, r2, #1              */
+		htole32(0x4a000074), /*   e8:  bmi   2c0 <done>              */
+		htole32(0xe4d14001), /*   ec:  ldrb  r4, [r1], #1            */
+		htole32(0xe4c04001), /*   f0:  strb  r4, [r0], #1            */
+		htole32(0xeafffffa), /*   f4:  b     e4 <up_bytes>           */
+		/* <up_shifted>: */
+		htole32(0xe3520004), /*   f8:  cmp   r2, #4                  */
+		htole32(0x3afffff8), /*   fc:  blo   e4 <up_bytes>           */
+		htole32(0xe201c003), /*  100:  and   r12, r1, #3             */
+		htole32(0xe3c11003), /*  104:  bic   r1, r1, #3              */
+		htole32(0xe4913004), /*  108:  ldr   r3, [r1], #4            */
+		htole32(0xe1a0c18c), /*  10c:  lsl   r12, r12, #3            */
+		htole32(0xe26ce020), /*  110:  rsb   lr, r12, #32            */
+		htole32(0xe2522020), /*  114:  subs  r2, r2, #32             */
+		htole32(0x3a000014), /*  118:  blo   170 <up_shifted+0x78>   */
+		htole32(0xe8b10ff0), /*  11c:  ldm   r1!, {r4, r5, r6, r7, r8, r9, r10, r11} */
+		htole32(0xe1a03c33), /*  120:  lsr   r3, r3, r12             */
+		htole32(0xe1833e14), /*  124:  orr   r3, r3, r4, lsl lr      */
+		htole32(0xe1a04c34), /*  128:  lsr   r4, r4, r12             */
+		htole32(0xe1844e15), /*  12c:  orr   r4, r4, r5, lsl lr      */
+		htole32(0xe1a05c35), /*  130:  lsr   r5, r5, r12             */
+		htole32(0xe1855e16), /*  134:  orr   r5, r5, r6, lsl lr      */
+		htole32(0xe1a06c36), /*  138:  lsr   r6, r6, r12             */
+		htole32(0xe1866e17), /*  13c:  orr   r6, r6, r7, lsl lr      */
+		htole32(0xe1a07c37), /*  140:  lsr   r7, r7, r12             */
+		htole32(0xe1877e18), /*  144:  orr   r7, r7, r8, lsl lr      */
+		htole32(0xe1a08c38), /*  148:  lsr   r8, r8, r12             */
+		htole32(0xe1888e19), /*  14c:  orr   r8, r8, r9, lsl lr      */
+		htole32(0xe1a09c39), /*  150:  lsr   r9, r9, r12             */
+		htole32(0xe1899e1a), /*  154:  orr   r9, r9, r10, lsl lr     */
+		htole32(0xe1a0ac3a), /*  158:  lsr   r10, r10, r12           */
+		htole32(0xe18aae1b), /*  15c:  orr   r10, r10, r11, lsl lr   */
+		htole32(0xe8a007f8), /*  160:  stm   r0!, {r3, r4, r5, r6, r7, r8, r9, r10} */
+		htole32(0xe1a0300b), /*  164:  mov   r3, r11                 */
+		htole32(0xe2522020), /*  168:  subs  r2, r2, #32             */
+		htole32(0x2affffea), /*  16c:  bhs   11c <up_shifted+0x24>   */
+		htole32(0xe292201c), /*  170:  adds  r2, r2, #28             */
+		htole32(0x3a000006), /*  174:  blo   194 <up_shifted+0x9c>   */
+		htole32(0xe4914004), /*  178:  ldr   r4, [r1], #4            */
+		htole32(0xe1a03c33), /*  17c:  lsr   r3, r3, r12             */
+		htole32(0xe1833e14), /*  180:  orr   r3, r3, r4, lsl lr      */
+		htole32(0xe4803004), /*  184:  str   r3, [r0], #4            */
+		htole32(0xe1a03004), /*  188:  mov   r3, r4                  */
+		htole32(0xe2522004), /*  18c:  subs  r2, r2, #4              */
+		htole32(0x2afffff8), /*  190:  bhs   178 <up_shifted+0x80>   */
+		htole32(0xe2822004), /*  194:  add   r2, r2, #4              */
+		htole32(0xe2411004), /*  198:  sub   r1, r1, #4              */
+		htole32(0xe08111ac), /*  19c:  add   r1, r1, r12, lsr #3     */
+		htole32(0xeaffffcf), /*  1a0:  b     e4 <up_bytes>           */
+		/* <copy_down>: */
+		htole32(0xe0800002), /*  1a4:  add   r0, r0, r2              */
+		htole32(0xe0811002), /*  1a8:  add   r1, r1, r2              */
+		htole32(0xe3100003), /*  1ac:  tst   r0, #3                  */
+		htole32(0x0a000004), /*  1b0:  beq   1c8 <copy_down+0x24>    */
+		htole32(0xe2522001), /*  1b4:  subs  r2, r2, #1              */
+		htole32(0x4a000040), /*  1b8:  bmi   2c0 <done>              */
+		htole32(0xe5714001), /*  1bc:  ldrb  r4, [r1, #-1]!          */
+		htole32(0xe5604001), /*  1c0:  strb  r4, [r0, #-1]!          */
+		htole32(0xeafffff8), /*  1c4:  b     1ac <copy_down+0x8>     */
+		htole32(0xe3110003), /*  1c8:  tst   r1, #3                  */
+		htole32(0x1a000011), /*  1cc:  bne   218 <down_shifted>      */
+		htole32(0xe2522020), /*  1d0:  subs  r2, r2, #32             */
+		htole32(0x3a000003), /*  1d4:  blo   1e8 <copy_down+0x44>    */
+		htole32(0xe9310ff0), /*  1d8:  ldmdb r1!, {r4, r5, r6, r7, r8, r9, r10, r11} */
+		htole32(0xe9200ff0), /*  1dc:  stmdb r0!, {r4, r5, r6, r7, r8, r9, r10, r11} */
+		htole32(0xe2522020), /*  1e0:  subs  r2, r2, #32             */
+		htole32(0x2afffffb), /*  1e4:  bhs   1d8 <copy_down+0x34>    */
+		htole32(0xe292201c), /*  1e8:  adds  r2, r2, #28             */
+		htole32(0x3a000003), /*  1ec:  blo   200 <copy_down+0x5c>    */
+		htole32(0xe5314004), /*  1f0:  ldr   r4, [r1, #-4]!          */
+		htole32(0xe5204004), /*  1f4:  str   r4, [r0, #-4]!          */
+		htole32(0xe2522004), /*  1f8:  subs  r2, r2, #4              */
+		htole32(0x2afffffb), /*  1fc:  bhs   1f0 <copy_down+0x4c>    */
+		htole32(0xe2822004), /*  200:  add   r2, r2, #4              */
+		/* <down_bytes>: */
+		htole32(0xe2522001), /*  204:  subs  r2, r2, #1              */
+		htole32(0x4a00002c), /*  208:  bmi   2c0 <done>              */
+		htole32(0xe5714001), /*  20c:  ldrb  r4, [r1, #-1]!          */
+		htole32(0xe5604001), /*  210:  strb  r4, [r0, #-1]!          */
+		htole32(0xeafffffa), /*  214:  b     204 <down_bytes>        */
+		/* <down_shifted>: */
+		htole32(0xe3520004), /*  218:  cmp   r2, #4                  */
+		htole32(0x3afffff8), /*  21c:  blo   204 <down_bytes>        */
+		htole32(0xe201c003), /*  220:  and   r12, r1, #3             */
+		htole32(0xe3c11003), /*  224:  bic   r1, r1, #3              */
+		htole32(0xe591b000), /*  228:  ldr   r11, [r1]               */
+		htole32(0xe1a0c18c), /*  22c:  lsl   r12, r12, #3            */
+		htole32(0xe26ce020), /*  230:  rsb   lr, r12, #32            */
+		htole32(0xe2522020), /*  234:  subs  r2, r2, #32             */
+		htole32(0x3a000014), /*  238:  blo   290 <down_shifted+0x78> */
+		htole32(0xe93107f8), /*  23c:  ldmdb r1!, {r3, r4, r5, r6, r7, r8, r9, r10} */
+		htole32(0xe1a0be1b), /*  240:  lsl   r11, r11, lr            */
+		htole32(0xe18bbc3a), /*  244:  orr   r11, r11, r10, lsr r12  */
+		htole32(0xe1a0ae1a), /*  248:  lsl   r10, r10, lr            */
+		htole32(0xe18aac39), /*  24c:  orr   r10, r10, r9, lsr r12   */
+		htole32(0xe1a09e19), /*  250:  lsl   r9, r9, lr              */
+		htole32(0xe1899c38), /*  254:  orr   r9, r9, r8, lsr r12     */
+		htole32(0xe1a08e18), /*  258:  lsl   r8, r8, lr              */
+		htole32(0xe1888c37), /*  25c:  orr   r8, r8, r7, lsr r12     */
+		htole32(0xe1a07e17), /*  260:  lsl   r7, r7, lr              */
+		htole32(0xe1877c36), /*  264:  orr   r7, r7, r6, lsr r12     */
+		htole32(0xe1a06e16), /*  268:  lsl   r6, r6, lr              */
+		htole32(0xe1866c35), /*  26c:  orr   r6, r6, r5, lsr r12     */
+		htole32(0xe1a05e15), /*  270:  lsl   r5, r5, lr              */
+		htole32(0xe1855c34), /*  274:  orr   r5, r5, r4, lsr r12     */
+		htole32(0xe1a04e14), /*  278:  lsl   r4, r4, lr              */
+		htole32(0xe1844c33), /*  27c:  orr   r4, r4, r3, lsr r12     */
+		htole32(0xe9200ff0), /*  280:  stmdb r0!, {r4, r5, r6, r7, r8, r9, r10, r11} */
+		htole32(0xe1a0b003), /*  284:  mov   r11, r3                 */
+		htole32(0xe2522020), /*  288:  subs  r2, r2, #32             */
+		htole32(0x2affffea), /*  28c:  bhs   23c <down_shifted+0x24> */
+		htole32(0xe292201c), /*  290:  adds  r2, r2, #28             */
+		htole32(0x3a000006), /*  294:  blo   2b4 <down_shifted+0x9c> */
+		htole32(0xe5313004), /*  298:  ldr   r3, [r1, #-4]!          */
+		htole32(0xe1a0be1b), /*  29c:  lsl   r11, r11, lr            */
+		htole32(0xe18bbc33), /*  2a0:  orr   r11, r11, r3, lsr r12   */
+		htole32(0xe520b004), /*  2a4:  str   r11, [r0, #-4]!         */
+		htole32(0xe1a0b003), /*  2a8:  mov   r11, r3                 */
+		htole32(0xe2522004), /*  2ac:  subs  r2, r2, #4              */
+		htole32(0x2afffff8), /*  2b0:  bhs   298 <down_shifted+0x80> */
+		htole32(0xe2822004), /*  2b4:  add   r2, r2, #4              */
+		htole32(0xe08111ac), /*  2b8:  add   r1, r1, r12, lsr #3     */
+		htole32(0xeaffffd0), /*  2bc:  b     204 <down_bytes>        */
+		/* <done>: */
+		htole32(0xe8bd8ff0), /*  2c0:  pop   {r4, r5, r6, r7, r8, r9, r10, r11, pc} */
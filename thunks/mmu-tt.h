@@ -0,0 +1,84 @@
+		/* <mmu_tt>: */
+		htole32(0xe92d0030), /*    0:  push  {r4, r5}                */
+		htole32(0xe59f011c), /*    4:  ldr   r0, [pc, #284]          */
+		htole32(0xe59f111c), /*    8:  ldr   r1, [pc, #284]          */
+		htole32(0xe3a03000), /*    c:  mov   r3, #0                  */
+		htole32(0xe2805c3f), /*   10:  add   r5, r0, #16128          */
+		htole32(0xe3110001), /*   14:  tst   r1, #1                  */
+		htole32(0x0a00000c), /*   18:  beq   50 <validate>           */
+		htole32(0xe300cde2), /*   1c:  movw  r12, #3554              */
+		htole32(0xe3a02000), /*   20:  mov   r2, #0                  */
+		htole32(0xe18c4a02), /*   24:  orr   r4, r12, r2, lsl #20    */
+		htole32(0xe7804102), /*   28:  str   r4, [r0, r2, lsl #2]    */
+		htole32(0xe2822001), /*   2c:  add   r2, r2, #1              */
+		htole32(0xe3520a01), /*   30:  cmp   r2, #4096               */
+		htole32(0x1afffffa), /*   34:  bne   24 <mmu_tt+0x24>        */
+		htole32(0xe5904000), /*   38:  ldr   r4, [r0]                */
+		htole32(0xe3844a01), /*   3c:  orr   r4, r4, #4096           */
+		htole32(0xe5804000), /*   40:  str   r4, [r0]                */
+		htole32(0xe59540fc), /*   44:  ldr   r4, [r5, #252]          */
+		htole32(0xe3844a01), /*   48:  orr   r4, r4, #4096           */
+		htole32(0xe58540fc), /*   4c:  str   r4, [r5, #252]          */
+		/* <validate>: */
+		htole32(0xe3110002), /*   50:  tst   r1, #2                  */
+		htole32(0x0a00000c), /*   54:  beq   8c <patch>              */
+		htole32(0xe3a02000), /*   58:  mov   r2, #0                  */
+		htole32(0xe7904102), /*   5c:  ldr   r4, [r0, r2, lsl #2]    */
+		htole32(0xe3140002), /*   60:  tst   r4, #2                  */
+		htole32(0x02833001), /*   64:  addeq r3, r3, #1              */
+		htole32(0xe3140701), /*   68:  tst   r4, #262144             */
+		htole32(0x12833001), /*   6c:  addne r3, r3, #1              */
+		htole32(0xe1520a24), /*   70:  cmp   r2, r4, lsr #20         */
+		htole32(0x12833001), /*   74:  addne r3, r3, #1              */
+		htole32(0xe2822001), /*   78:  add   r2, r2, #1              */
+		htole32(0xe3520a01), /*   7c:  cmp   r2, #4096               */
+		htole32(0x1afffff5), /*   80:  bne   5c <validate+0xc>       */
+		htole32(0xe3530000), /*   84:  cmp   r3, #0                  */
+		htole32(0x1a000023), /*   88:  bne   11c <done>              */
+		/* <patch>: */
+		htole32(0xe3110004), /*   8c:  tst   r1, #4                  */
+		htole32(0x0a000008), /*   90:  beq   b8 <patch_brom>         */
+		htole32(0xe3a02b01), /*   94:  mov   r2, #1024               */
+		htole32(0xe7904102), /*   98:  ldr   r4, [r0, r2, lsl #2]    */
+		htole32(0xe3c44a07), /*   9c:  bic   r4, r4, #28672          */
+		htole32(0xe3c4400c), /*   a0:  bic   r4, r4, #12             */
+		htole32(0xe3844a01), /*   a4:  orr   r4, r4, #4096           */
+		htole32(0xe7804102), /*   a8:  str   r4, [r0, r2, lsl #2]    */
+		htole32(0xe2822001), /*   ac:  add   r2, r2, #1              */
+		htole32(0xe3520b03), /*   b0:  cmp   r2, #3072               */
+		htole32(0x1afffff7), /*   b4:  bne   98 <patch+0xc>          */
+		/* <patch_brom>: */
+		htole32(0xe3110020), /*   b8:  tst   r1, #32                 */
+		htole32(0x0a000004), /*   bc:  beq   d4 <disable>            */
+		htole32(0xe59540fc), /*   c0:  ldr   r4, [r5, #252]          */
+		htole32(0xe3c44a07), /*   c4:  bic   r4, r4, #28672          */
+		htole32(0xe3844a01), /*   c8:  orr   r4, r4, #4096           */
+		htole32(0xe384400c), /*   cc:  orr   r4, r4, #12             */
+		htole32(0xe58540fc), /*   d0:  str   r4, [r5, #252]          */
+		/* <disable>: */
+		htole32(0xe3110008), /*   d4:  tst   r1, #8                  */
+		htole32(0x0a000003), /*   d8:  beq   ec <enable>             */
+		htole32(0xee114f10), /*   dc:  mrc   p15, #0, r4, c1, c0, #0 */
+		htole32(0xe3c44001), /*   e0:  bic   r4, r4, #1              */
+		htole32(0xe3c44b06), /*   e4:  bic   r4, r4, #6144           */
+		htole32(0xee014f10), /*   e8:  mcr   p15, #0, r4, c1, c0, #0 */
+		/* <enable>: */
+		htole32(0xe3110010), /*   ec:  tst   r1, #16                 */
+		htole32(0x0a000009), /*   f0:  beq   11c <done>              */
+		htole32(0xe3a04000), /*   f4:  mov   r4, #0                  */
+		htole32(0xee084f17), /*   f8:  mcr   p15, #0, r4, c8, c7, #0 */
+		htole32(0xee074f15), /*   fc:  mcr   p15, #0, r4, c7, c5, #0 */
+		htole32(0xee074fd5), /*  100:  mcr   p15, #0, r4, c7, c5, #6 */
+		htole32(0xf57ff04f), /*  104:  dsb   sy                      */
+		htole32(0xf57ff06f), /*  108:  isb   sy                      */
+		htole32(0xee114f10), /*  10c:  mrc   p15, #0, r4, c1, c0, #0 */
+		htole32(0xe3844001), /*  110:  orr   r4, r4, #1              */
+		htole32(0xe3844b06), /*  114:  orr   r4, r4, #6144           */
+		htole32(0xee014f10), /*  118:  mcr   p15, #0, r4, c1, c0, #0 */
+		/* <done>: */
+		htole32(0xe58f300c), /*  11c:  str   r3, [pc, #12]           */
+		htole32(0xe8bd0030), /*  120:  pop   {r4, r5}                */
+		htole32(0xe12fff1e), /*  124:  bx    lr                      */
+		/* <tt_addr>: */
+		/* <tt_mode>: */
+		/* <tt_result>: */
@@ -0,0 +1,2 @@
+/* Auto-generated information. DO NOT EDIT */
+#define VERSION "9caf4b2-dirty"